@@ -23,10 +23,18 @@
 
 #include "freedreno_layout.h"
 
+#include "util/u_cpu_detect.h"
+
 #if DETECT_ARCH_AARCH64
 #include <arm_neon.h>
 #endif
 
+#define USE_X86_KERNELS (DETECT_ARCH_X86 || DETECT_ARCH_X86_64)
+
+#if USE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
 /* The tiling scheme on Qualcomm consists of four levels:
  *
  * 1. The UBWC block. Normally these use a compressed encoding format with the
@@ -223,7 +231,6 @@ get_bank_shift(const struct fdl_ubwc_config *config)
    return config->highest_bank_bit - 3;
 }
 
-#if USE_SLOW_PATH
 static uint32_t
 get_block_offset(uint32_t x, uint32_t y, unsigned block_stride, unsigned cpp,
                  const struct fdl_ubwc_config *config)
@@ -244,7 +251,6 @@ get_block_offset(uint32_t x, uint32_t y, unsigned block_stride, unsigned cpp,
    uint32_t macrotile_stride = block_stride / 2;
    return ((x_mask ^ y_mask) >> 8) + ((macrotile_y * macrotile_stride) << 3);
 }
-#endif
 
 static void
 get_block_size(unsigned cpp, uint32_t *block_width,
@@ -525,7 +531,7 @@ tiled_to_linear_2cpp(char *_tiled, char *_linear, uint32_t linear_pitch)
             "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15");
    }
 #else
-   memcpy_small<2, LINEAR_TO_TILED, FDL_MACROTILE_4_CHANNEL>(
+   memcpy_small<2, TILED_TO_LINEAR, FDL_MACROTILE_4_CHANNEL>(
       0, 0, 32, 4, _tiled, _linear, linear_pitch, 0, &dummy_config);
 #endif
 }
@@ -730,6 +736,431 @@ tiled_to_linear_16cpp(char *_tiled, char *_linear, uint32_t linear_pitch)
    }
 }
 
+#if USE_X86_KERNELS
+
+/* x86 versions of the block kernels. These are built with target attributes
+ * and selected at runtime, so that the rest of the file doesn't depend on
+ * which instruction set extensions the compiler is allowed to use.
+ *
+ * The shuffles are the same as the NEON versions above, with unpacklo/unpackhi
+ * standing in for zip1/zip2. The AVX2 versions work on two 16 byte columns at
+ * once and use permute2x128 to fix up the order across 128-bit lanes, because
+ * the unpack instructions only operate within a lane.
+ */
+
+#define SSE2_FUNC __attribute__((target("sse2")))
+#define AVX2_FUNC __attribute__((target("avx2")))
+
+#define SHUF_3120 _MM_SHUFFLE(3, 1, 2, 0)
+
+static inline SSE2_FUNC __m128i
+load_128(const char *p)
+{
+   return _mm_loadu_si128((const __m128i *)p);
+}
+
+static inline SSE2_FUNC void
+store_128(char *p, __m128i v)
+{
+   _mm_storeu_si128((__m128i *)p, v);
+}
+
+static inline AVX2_FUNC __m256i
+load_256(const char *p)
+{
+   return _mm256_loadu_si256((const __m256i *)p);
+}
+
+static inline AVX2_FUNC void
+store_256(char *p, __m256i v)
+{
+   _mm256_storeu_si256((__m256i *)p, v);
+}
+
+/* Separate the even and odd 16-bit elements of each 64-bit half, so that
+ * [a0 b0 a1 b1 a2 b2 a3 b3] becomes [a0 a1 a2 a3 b0 b1 b2 b3].
+ */
+static inline SSE2_FUNC __m128i
+unzip_epi16_sse2(__m128i v)
+{
+   v = _mm_shufflelo_epi16(v, SHUF_3120);
+   v = _mm_shufflehi_epi16(v, SHUF_3120);
+   return _mm_shuffle_epi32(v, SHUF_3120);
+}
+
+static inline AVX2_FUNC __m256i
+unzip_epi16_avx2(__m256i v)
+{
+   v = _mm256_shufflelo_epi16(v, SHUF_3120);
+   v = _mm256_shufflehi_epi16(v, SHUF_3120);
+   return _mm256_shuffle_epi32(v, SHUF_3120);
+}
+
+static SSE2_FUNC void
+linear_to_tiled_1cpp_sse2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned y = 0; y < 2; y++, linear += 4 * linear_pitch) {
+      for (unsigned x = 0; x < 2; x++, tiled += 64) {
+         __m128i r0 = load_128(linear + 16 * x);
+         __m128i r1 = load_128(linear + linear_pitch + 16 * x);
+         __m128i r2 = load_128(linear + 2 * linear_pitch + 16 * x);
+         __m128i r3 = load_128(linear + 3 * linear_pitch + 16 * x);
+         __m128i a0 = _mm_unpacklo_epi16(r0, r1);
+         __m128i b0 = _mm_unpacklo_epi16(r2, r3);
+         __m128i a1 = _mm_unpackhi_epi16(r0, r1);
+         __m128i b1 = _mm_unpackhi_epi16(r2, r3);
+         store_128(tiled + 0, _mm_unpacklo_epi64(a0, b0));
+         store_128(tiled + 16, _mm_unpackhi_epi64(a0, b0));
+         store_128(tiled + 32, _mm_unpacklo_epi64(a1, b1));
+         store_128(tiled + 48, _mm_unpackhi_epi64(a1, b1));
+      }
+   }
+}
+
+static SSE2_FUNC void
+tiled_to_linear_1cpp_sse2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned y = 0; y < 2; y++, linear += 4 * linear_pitch) {
+      for (unsigned x = 0; x < 2; x++, tiled += 64) {
+         __m128i t0 = load_128(tiled + 0);
+         __m128i t1 = load_128(tiled + 16);
+         __m128i t2 = load_128(tiled + 32);
+         __m128i t3 = load_128(tiled + 48);
+         __m128i a0 = unzip_epi16_sse2(_mm_unpacklo_epi64(t0, t1));
+         __m128i b0 = unzip_epi16_sse2(_mm_unpackhi_epi64(t0, t1));
+         __m128i a1 = unzip_epi16_sse2(_mm_unpacklo_epi64(t2, t3));
+         __m128i b1 = unzip_epi16_sse2(_mm_unpackhi_epi64(t2, t3));
+         store_128(linear + 16 * x, _mm_unpacklo_epi64(a0, a1));
+         store_128(linear + linear_pitch + 16 * x, _mm_unpackhi_epi64(a0, a1));
+         store_128(linear + 2 * linear_pitch + 16 * x,
+                   _mm_unpacklo_epi64(b0, b1));
+         store_128(linear + 3 * linear_pitch + 16 * x,
+                   _mm_unpackhi_epi64(b0, b1));
+      }
+   }
+}
+
+static AVX2_FUNC void
+linear_to_tiled_1cpp_avx2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned y = 0; y < 2; y++, linear += 4 * linear_pitch, tiled += 128) {
+      __m256i r0 = load_256(linear);
+      __m256i r1 = load_256(linear + linear_pitch);
+      __m256i r2 = load_256(linear + 2 * linear_pitch);
+      __m256i r3 = load_256(linear + 3 * linear_pitch);
+      __m256i a0 = _mm256_unpacklo_epi16(r0, r1);
+      __m256i b0 = _mm256_unpacklo_epi16(r2, r3);
+      __m256i a1 = _mm256_unpackhi_epi16(r0, r1);
+      __m256i b1 = _mm256_unpackhi_epi16(r2, r3);
+      __m256i t0 = _mm256_unpacklo_epi64(a0, b0);
+      __m256i t1 = _mm256_unpackhi_epi64(a0, b0);
+      __m256i t2 = _mm256_unpacklo_epi64(a1, b1);
+      __m256i t3 = _mm256_unpackhi_epi64(a1, b1);
+      store_256(tiled + 0, _mm256_permute2x128_si256(t0, t1, 0x20));
+      store_256(tiled + 32, _mm256_permute2x128_si256(t2, t3, 0x20));
+      store_256(tiled + 64, _mm256_permute2x128_si256(t0, t1, 0x31));
+      store_256(tiled + 96, _mm256_permute2x128_si256(t2, t3, 0x31));
+   }
+}
+
+static AVX2_FUNC void
+tiled_to_linear_1cpp_avx2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned y = 0; y < 2; y++, linear += 4 * linear_pitch, tiled += 128) {
+      __m256i c0 = load_256(tiled + 0);
+      __m256i c1 = load_256(tiled + 32);
+      __m256i c2 = load_256(tiled + 64);
+      __m256i c3 = load_256(tiled + 96);
+      __m256i t0 = _mm256_permute2x128_si256(c0, c2, 0x20);
+      __m256i t1 = _mm256_permute2x128_si256(c0, c2, 0x31);
+      __m256i t2 = _mm256_permute2x128_si256(c1, c3, 0x20);
+      __m256i t3 = _mm256_permute2x128_si256(c1, c3, 0x31);
+      __m256i a0 = unzip_epi16_avx2(_mm256_unpacklo_epi64(t0, t1));
+      __m256i b0 = unzip_epi16_avx2(_mm256_unpackhi_epi64(t0, t1));
+      __m256i a1 = unzip_epi16_avx2(_mm256_unpacklo_epi64(t2, t3));
+      __m256i b1 = unzip_epi16_avx2(_mm256_unpackhi_epi64(t2, t3));
+      store_256(linear, _mm256_unpacklo_epi64(a0, a1));
+      store_256(linear + linear_pitch, _mm256_unpackhi_epi64(a0, a1));
+      store_256(linear + 2 * linear_pitch, _mm256_unpacklo_epi64(b0, b1));
+      store_256(linear + 3 * linear_pitch, _mm256_unpackhi_epi64(b0, b1));
+   }
+}
+
+static SSE2_FUNC void
+linear_to_tiled_2cpp_sse2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 4; x++, linear += 16, tiled += 64) {
+      __m128i r0 = load_128(linear);
+      __m128i r1 = load_128(linear + linear_pitch);
+      __m128i r2 = load_128(linear + 2 * linear_pitch);
+      __m128i r3 = load_128(linear + 3 * linear_pitch);
+      store_128(tiled + 0, _mm_unpacklo_epi32(r0, r1));
+      store_128(tiled + 16, _mm_unpacklo_epi32(r2, r3));
+      store_128(tiled + 32, _mm_unpackhi_epi32(r0, r1));
+      store_128(tiled + 48, _mm_unpackhi_epi32(r2, r3));
+   }
+}
+
+static SSE2_FUNC void
+tiled_to_linear_2cpp_sse2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 4; x++, linear += 16, tiled += 64) {
+      __m128i t0 = _mm_shuffle_epi32(load_128(tiled + 0), SHUF_3120);
+      __m128i t1 = _mm_shuffle_epi32(load_128(tiled + 16), SHUF_3120);
+      __m128i t2 = _mm_shuffle_epi32(load_128(tiled + 32), SHUF_3120);
+      __m128i t3 = _mm_shuffle_epi32(load_128(tiled + 48), SHUF_3120);
+      store_128(linear, _mm_unpacklo_epi64(t0, t2));
+      store_128(linear + linear_pitch, _mm_unpackhi_epi64(t0, t2));
+      store_128(linear + 2 * linear_pitch, _mm_unpacklo_epi64(t1, t3));
+      store_128(linear + 3 * linear_pitch, _mm_unpackhi_epi64(t1, t3));
+   }
+}
+
+static AVX2_FUNC void
+linear_to_tiled_2cpp_avx2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 2; x++, linear += 32, tiled += 128) {
+      __m256i r0 = load_256(linear);
+      __m256i r1 = load_256(linear + linear_pitch);
+      __m256i r2 = load_256(linear + 2 * linear_pitch);
+      __m256i r3 = load_256(linear + 3 * linear_pitch);
+      __m256i lo01 = _mm256_unpacklo_epi32(r0, r1);
+      __m256i lo23 = _mm256_unpacklo_epi32(r2, r3);
+      __m256i hi01 = _mm256_unpackhi_epi32(r0, r1);
+      __m256i hi23 = _mm256_unpackhi_epi32(r2, r3);
+      store_256(tiled + 0, _mm256_permute2x128_si256(lo01, lo23, 0x20));
+      store_256(tiled + 32, _mm256_permute2x128_si256(hi01, hi23, 0x20));
+      store_256(tiled + 64, _mm256_permute2x128_si256(lo01, lo23, 0x31));
+      store_256(tiled + 96, _mm256_permute2x128_si256(hi01, hi23, 0x31));
+   }
+}
+
+static AVX2_FUNC void
+tiled_to_linear_2cpp_avx2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 2; x++, linear += 32, tiled += 128) {
+      __m256i c0 = load_256(tiled + 0);
+      __m256i c1 = load_256(tiled + 32);
+      __m256i c2 = load_256(tiled + 64);
+      __m256i c3 = load_256(tiled + 96);
+      __m256i lo01 = _mm256_permute2x128_si256(c0, c2, 0x20);
+      __m256i lo23 = _mm256_permute2x128_si256(c0, c2, 0x31);
+      __m256i hi01 = _mm256_permute2x128_si256(c1, c3, 0x20);
+      __m256i hi23 = _mm256_permute2x128_si256(c1, c3, 0x31);
+      lo01 = _mm256_shuffle_epi32(lo01, SHUF_3120);
+      lo23 = _mm256_shuffle_epi32(lo23, SHUF_3120);
+      hi01 = _mm256_shuffle_epi32(hi01, SHUF_3120);
+      hi23 = _mm256_shuffle_epi32(hi23, SHUF_3120);
+      store_256(linear, _mm256_unpacklo_epi64(lo01, hi01));
+      store_256(linear + linear_pitch, _mm256_unpackhi_epi64(lo01, hi01));
+      store_256(linear + 2 * linear_pitch, _mm256_unpacklo_epi64(lo23, hi23));
+      store_256(linear + 3 * linear_pitch, _mm256_unpackhi_epi64(lo23, hi23));
+   }
+}
+
+static SSE2_FUNC void
+linear_to_tiled_4cpp_sse2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 4; x++, linear += 16, tiled += 64) {
+      __m128i r0 = load_128(linear);
+      __m128i r1 = load_128(linear + linear_pitch);
+      __m128i r2 = load_128(linear + 2 * linear_pitch);
+      __m128i r3 = load_128(linear + 3 * linear_pitch);
+      store_128(tiled + 0, _mm_unpacklo_epi64(r0, r1));
+      store_128(tiled + 16, _mm_unpackhi_epi64(r0, r1));
+      store_128(tiled + 32, _mm_unpacklo_epi64(r2, r3));
+      store_128(tiled + 48, _mm_unpackhi_epi64(r2, r3));
+   }
+}
+
+static SSE2_FUNC void
+tiled_to_linear_4cpp_sse2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 4; x++, linear += 16, tiled += 64) {
+      __m128i t0 = load_128(tiled + 0);
+      __m128i t1 = load_128(tiled + 16);
+      __m128i t2 = load_128(tiled + 32);
+      __m128i t3 = load_128(tiled + 48);
+      store_128(linear, _mm_unpacklo_epi64(t0, t1));
+      store_128(linear + linear_pitch, _mm_unpackhi_epi64(t0, t1));
+      store_128(linear + 2 * linear_pitch, _mm_unpacklo_epi64(t2, t3));
+      store_128(linear + 3 * linear_pitch, _mm_unpackhi_epi64(t2, t3));
+   }
+}
+
+static AVX2_FUNC void
+linear_to_tiled_4cpp_avx2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 2; x++, linear += 32, tiled += 128) {
+      __m256i r0 = load_256(linear);
+      __m256i r1 = load_256(linear + linear_pitch);
+      __m256i r2 = load_256(linear + 2 * linear_pitch);
+      __m256i r3 = load_256(linear + 3 * linear_pitch);
+      __m256i lo01 = _mm256_unpacklo_epi64(r0, r1);
+      __m256i hi01 = _mm256_unpackhi_epi64(r0, r1);
+      __m256i lo23 = _mm256_unpacklo_epi64(r2, r3);
+      __m256i hi23 = _mm256_unpackhi_epi64(r2, r3);
+      store_256(tiled + 0, _mm256_permute2x128_si256(lo01, hi01, 0x20));
+      store_256(tiled + 32, _mm256_permute2x128_si256(lo23, hi23, 0x20));
+      store_256(tiled + 64, _mm256_permute2x128_si256(lo01, hi01, 0x31));
+      store_256(tiled + 96, _mm256_permute2x128_si256(lo23, hi23, 0x31));
+   }
+}
+
+static AVX2_FUNC void
+tiled_to_linear_4cpp_avx2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 2; x++, linear += 32, tiled += 128) {
+      __m256i c0 = load_256(tiled + 0);
+      __m256i c1 = load_256(tiled + 32);
+      __m256i c2 = load_256(tiled + 64);
+      __m256i c3 = load_256(tiled + 96);
+      __m256i lo01 = _mm256_permute2x128_si256(c0, c2, 0x20);
+      __m256i hi01 = _mm256_permute2x128_si256(c0, c2, 0x31);
+      __m256i lo23 = _mm256_permute2x128_si256(c1, c3, 0x20);
+      __m256i hi23 = _mm256_permute2x128_si256(c1, c3, 0x31);
+      store_256(linear, _mm256_unpacklo_epi64(lo01, hi01));
+      store_256(linear + linear_pitch, _mm256_unpackhi_epi64(lo01, hi01));
+      store_256(linear + 2 * linear_pitch, _mm256_unpacklo_epi64(lo23, hi23));
+      store_256(linear + 3 * linear_pitch, _mm256_unpackhi_epi64(lo23, hi23));
+   }
+}
+
+/* For 8 and 16 cpp the 16 byte pixel pairs/pixels are just moved around
+ * without any shuffling.
+ */
+
+static SSE2_FUNC void
+linear_to_tiled_8cpp_sse2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 2; x++, linear += 4 * 8) {
+      for (unsigned y = 0; y < 2; y++, tiled += 64) {
+         char *linear0 = linear + 2 * y * linear_pitch;
+         char *linear1 = linear0 + linear_pitch;
+         __m128i p00 = load_128(linear0);
+         __m128i p10 = load_128(linear0 + 16);
+         __m128i p01 = load_128(linear1);
+         __m128i p11 = load_128(linear1 + 16);
+         store_128(tiled + 0, p00);
+         store_128(tiled + 16, p01);
+         store_128(tiled + 32, p10);
+         store_128(tiled + 48, p11);
+      }
+   }
+}
+
+static SSE2_FUNC void
+tiled_to_linear_8cpp_sse2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 2; x++, linear += 4 * 8) {
+      for (unsigned y = 0; y < 2; y++, tiled += 64) {
+         char *linear0 = linear + 2 * y * linear_pitch;
+         char *linear1 = linear0 + linear_pitch;
+         __m128i p00 = load_128(tiled + 0);
+         __m128i p01 = load_128(tiled + 16);
+         __m128i p10 = load_128(tiled + 32);
+         __m128i p11 = load_128(tiled + 48);
+         store_128(linear0, p00);
+         store_128(linear0 + 16, p10);
+         store_128(linear1, p01);
+         store_128(linear1 + 16, p11);
+      }
+   }
+}
+
+static AVX2_FUNC void
+linear_to_tiled_8cpp_avx2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 2; x++, linear += 4 * 8) {
+      for (unsigned y = 0; y < 2; y++, tiled += 64) {
+         char *linear0 = linear + 2 * y * linear_pitch;
+         __m256i r0 = load_256(linear0);
+         __m256i r1 = load_256(linear0 + linear_pitch);
+         store_256(tiled + 0, _mm256_permute2x128_si256(r0, r1, 0x20));
+         store_256(tiled + 32, _mm256_permute2x128_si256(r0, r1, 0x31));
+      }
+   }
+}
+
+static AVX2_FUNC void
+tiled_to_linear_8cpp_avx2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned x = 0; x < 2; x++, linear += 4 * 8) {
+      for (unsigned y = 0; y < 2; y++, tiled += 64) {
+         char *linear0 = linear + 2 * y * linear_pitch;
+         __m256i t0 = load_256(tiled + 0);
+         __m256i t1 = load_256(tiled + 32);
+         store_256(linear0, _mm256_permute2x128_si256(t0, t1, 0x20));
+         store_256(linear0 + linear_pitch,
+                   _mm256_permute2x128_si256(t0, t1, 0x31));
+      }
+   }
+}
+
+static SSE2_FUNC void
+linear_to_tiled_16cpp_sse2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned y = 0; y < 2; y++, linear += 2 * linear_pitch) {
+      for (unsigned x = 0; x < 2; x++, tiled += 64) {
+         char *linear0 = linear + 2 * 16 * x;
+         char *linear1 = linear0 + linear_pitch;
+         __m128i p00 = load_128(linear0);
+         __m128i p10 = load_128(linear0 + 16);
+         __m128i p01 = load_128(linear1);
+         __m128i p11 = load_128(linear1 + 16);
+         store_128(tiled + 0, p00);
+         store_128(tiled + 16, p10);
+         store_128(tiled + 32, p01);
+         store_128(tiled + 48, p11);
+      }
+   }
+}
+
+static SSE2_FUNC void
+tiled_to_linear_16cpp_sse2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned y = 0; y < 2; y++, linear += 2 * linear_pitch) {
+      for (unsigned x = 0; x < 2; x++, tiled += 64) {
+         char *linear0 = linear + 2 * 16 * x;
+         char *linear1 = linear0 + linear_pitch;
+         __m128i p00 = load_128(tiled + 0);
+         __m128i p10 = load_128(tiled + 16);
+         __m128i p01 = load_128(tiled + 32);
+         __m128i p11 = load_128(tiled + 48);
+         store_128(linear0, p00);
+         store_128(linear0 + 16, p10);
+         store_128(linear1, p01);
+         store_128(linear1 + 16, p11);
+      }
+   }
+}
+
+static AVX2_FUNC void
+linear_to_tiled_16cpp_avx2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned y = 0; y < 2; y++, linear += 2 * linear_pitch) {
+      for (unsigned x = 0; x < 2; x++, tiled += 64) {
+         char *linear0 = linear + 2 * 16 * x;
+         store_256(tiled + 0, load_256(linear0));
+         store_256(tiled + 32, load_256(linear0 + linear_pitch));
+      }
+   }
+}
+
+static AVX2_FUNC void
+tiled_to_linear_16cpp_avx2(char *tiled, char *linear, uint32_t linear_pitch)
+{
+   for (unsigned y = 0; y < 2; y++, linear += 2 * linear_pitch) {
+      for (unsigned x = 0; x < 2; x++, tiled += 64) {
+         char *linear0 = linear + 2 * 16 * x;
+         store_256(linear0, load_256(tiled + 0));
+         store_256(linear0 + linear_pitch, load_256(tiled + 32));
+      }
+   }
+}
+
+#endif /* USE_X86_KERNELS */
+
 template<unsigned cpp, enum copy_dir direction, copy_fn copy_block,
    enum fdl_macrotile_mode macrotile_mode>
 static void
@@ -843,14 +1274,148 @@ memcpy_large(uint32_t x_start, uint32_t y_start,
    }
 }
 
+/* Instantiate memcpy_large for both macrotile modes, so that the kernel can
+ * be chosen with a single function pointer.
+ */
+typedef void (*memcpy_large_fn)(uint32_t x_start, uint32_t y_start,
+                                uint32_t width, uint32_t height,
+                                char *tiled, char *linear,
+                                uint32_t linear_pitch, uint32_t block_stride,
+                                const fdl_ubwc_config *config);
+
+template<unsigned cpp, enum copy_dir direction, copy_fn copy_block>
+static void
+memcpy_large_any_mode(uint32_t x_start, uint32_t y_start,
+                      uint32_t width, uint32_t height,
+                      char *tiled, char *linear,
+                      uint32_t linear_pitch, uint32_t block_stride,
+                      const fdl_ubwc_config *config)
+{
+   if (config->macrotile_mode == FDL_MACROTILE_4_CHANNEL) {
+      memcpy_large<cpp, direction, copy_block, FDL_MACROTILE_4_CHANNEL>(
+         x_start, y_start, width, height, tiled, linear, linear_pitch,
+         block_stride, config);
+   } else {
+      memcpy_large<cpp, direction, copy_block, FDL_MACROTILE_8_CHANNEL>(
+         x_start, y_start, width, height, tiled, linear, linear_pitch,
+         block_stride, config);
+   }
+}
+
+#define KERNELS(dir, name, suffix)                                            \
+   {                                                                          \
+      memcpy_large_any_mode<1, dir, name##_1cpp##suffix>,                     \
+      memcpy_large_any_mode<2, dir, name##_2cpp##suffix>,                     \
+      memcpy_large_any_mode<4, dir, name##_4cpp##suffix>,                     \
+      memcpy_large_any_mode<8, dir, name##_8cpp##suffix>,                     \
+      memcpy_large_any_mode<16, dir, name##_16cpp##suffix>,                   \
+   }
+
+/* Indexed by log2(cpp) */
+static const memcpy_large_fn linear_to_tiled_generic[] =
+   KERNELS(LINEAR_TO_TILED, linear_to_tiled, );
+static const memcpy_large_fn tiled_to_linear_generic[] =
+   KERNELS(TILED_TO_LINEAR, tiled_to_linear, );
+
+#if USE_X86_KERNELS
+static const memcpy_large_fn linear_to_tiled_sse2[] =
+   KERNELS(LINEAR_TO_TILED, linear_to_tiled, _sse2);
+static const memcpy_large_fn tiled_to_linear_sse2[] =
+   KERNELS(TILED_TO_LINEAR, tiled_to_linear, _sse2);
+static const memcpy_large_fn linear_to_tiled_avx2[] =
+   KERNELS(LINEAR_TO_TILED, linear_to_tiled, _avx2);
+static const memcpy_large_fn tiled_to_linear_avx2[] =
+   KERNELS(TILED_TO_LINEAR, tiled_to_linear, _avx2);
+#endif
+
+#undef KERNELS
+
+bool
+fdl6_tiled_memcpy_impl_supported(enum fdl_tiled_memcpy_impl impl)
+{
+   switch (impl) {
+   case FDL_TILED_MEMCPY_AUTO:
+   case FDL_TILED_MEMCPY_REFERENCE:
+   case FDL_TILED_MEMCPY_GENERIC:
+      return true;
+#if USE_X86_KERNELS
+   case FDL_TILED_MEMCPY_SSE2:
+      return util_get_cpu_caps()->has_sse2;
+   case FDL_TILED_MEMCPY_AVX2:
+      return util_get_cpu_caps()->has_avx2;
+#endif
+   default:
+      return false;
+   }
+}
+
+const char *
+fdl6_tiled_memcpy_impl_name(enum fdl_tiled_memcpy_impl impl)
+{
+   switch (impl) {
+   case FDL_TILED_MEMCPY_AUTO:
+      return "auto";
+   case FDL_TILED_MEMCPY_REFERENCE:
+      return "reference";
+   case FDL_TILED_MEMCPY_GENERIC:
+      return "generic";
+   case FDL_TILED_MEMCPY_SSE2:
+      return "sse2";
+   case FDL_TILED_MEMCPY_AVX2:
+      return "avx2";
+   default:
+      return "unknown";
+   }
+}
+
+static enum fdl_tiled_memcpy_impl
+resolve_impl(enum fdl_tiled_memcpy_impl impl)
+{
+   if (impl != FDL_TILED_MEMCPY_AUTO) {
+      assert(fdl6_tiled_memcpy_impl_supported(impl));
+      return impl;
+   }
+
+#if USE_SLOW_PATH
+   return FDL_TILED_MEMCPY_REFERENCE;
+#else
+   if (fdl6_tiled_memcpy_impl_supported(FDL_TILED_MEMCPY_AVX2))
+      return FDL_TILED_MEMCPY_AVX2;
+   if (fdl6_tiled_memcpy_impl_supported(FDL_TILED_MEMCPY_SSE2))
+      return FDL_TILED_MEMCPY_SSE2;
+   return FDL_TILED_MEMCPY_GENERIC;
+#endif
+}
+
+static const memcpy_large_fn *
+get_kernels(enum copy_dir direction, enum fdl_tiled_memcpy_impl impl)
+{
+   switch (impl) {
+#if USE_X86_KERNELS
+   case FDL_TILED_MEMCPY_SSE2:
+      return direction == LINEAR_TO_TILED ? linear_to_tiled_sse2 :
+                                            tiled_to_linear_sse2;
+   case FDL_TILED_MEMCPY_AVX2:
+      return direction == LINEAR_TO_TILED ? linear_to_tiled_avx2 :
+                                            tiled_to_linear_avx2;
+#endif
+   case FDL_TILED_MEMCPY_GENERIC:
+      return direction == LINEAR_TO_TILED ? linear_to_tiled_generic :
+                                            tiled_to_linear_generic;
+   default:
+      unreachable("unknown tiled memcpy implementation");
+   }
+}
+
 void
-fdl6_memcpy_linear_to_tiled(uint32_t x_start, uint32_t y_start,
-                            uint32_t width, uint32_t height,
-                            char *dst, const char *src,
-                            const struct fdl_layout *dst_layout,
-                            unsigned dst_miplevel,
-                            uint32_t src_pitch,
-                            const struct fdl_ubwc_config *config)
+fdl6_memcpy_linear_to_tiled_impl(uint32_t x_start, uint32_t y_start,
+                                 uint32_t width, uint32_t height,
+                                 char *dst, const char *src,
+                                 const struct fdl_layout *dst_layout,
+                                 unsigned dst_miplevel,
+                                 uint32_t src_pitch,
+                                 const struct fdl_ubwc_config *config,
+                                 enum fdl_tiled_memcpy_impl impl)
 {
    unsigned block_width, block_height;
    uint32_t cpp = dst_layout->cpp;
@@ -861,59 +1426,42 @@ fdl6_memcpy_linear_to_tiled(uint32_t x_start, uint32_t y_start,
    assert(block_size == block_width * block_height * dst_layout->cpp);
    assert(config->macrotile_mode != FDL_MACROTILE_INVALID);
 
-#if USE_SLOW_PATH
-   for (uint32_t y = 0; y < height; y++) {
-      uint32_t y_block = (y + y_start) / block_height;
-      uint32_t y_pixel = (y + y_start) % block_height;
-      for (uint32_t x = 0; x < width; x++) {
-         uint32_t x_block = (x + x_start) / block_width;
-         uint32_t x_pixel = (x + x_start) % block_width;
+   impl = resolve_impl(impl);
 
-         uint32_t block_offset = 
-            get_block_offset(x_block, y_block, block_stride, cpp,
-                             config);
-         uint32_t pixel_offset = get_pixel_offset(x_pixel, y_pixel);
+   if (impl == FDL_TILED_MEMCPY_REFERENCE) {
+      for (uint32_t y = 0; y < height; y++) {
+         uint32_t y_block = (y + y_start) / block_height;
+         uint32_t y_pixel = (y + y_start) % block_height;
+         for (uint32_t x = 0; x < width; x++) {
+            uint32_t x_block = (x + x_start) / block_width;
+            uint32_t x_pixel = (x + x_start) % block_width;
 
-         memcpy(dst + block_size * block_offset + cpp * pixel_offset,
-                src + y * src_pitch + x * cpp, cpp);
+            uint32_t block_offset =
+               get_block_offset(x_block, y_block, block_stride, cpp,
+                                config);
+            uint32_t pixel_offset = get_pixel_offset(x_pixel, y_pixel);
+
+            memcpy(dst + block_size * block_offset + cpp * pixel_offset,
+                   src + y * src_pitch + x * cpp, cpp);
+         }
       }
+      return;
    }
-#else
-   switch (cpp) {
-#define CASE(case_cpp)                                                        \
-   case case_cpp:                                                             \
-      if (config->macrotile_mode == FDL_MACROTILE_4_CHANNEL) {                \
-         memcpy_large<case_cpp, LINEAR_TO_TILED,                              \
-            linear_to_tiled_##case_cpp##cpp, FDL_MACROTILE_4_CHANNEL>(        \
-            x_start, y_start, width, height, dst, (char *)src, src_pitch,     \
-            block_stride, config);                                            \
-      } else {                                                                \
-         memcpy_large<case_cpp, LINEAR_TO_TILED,                              \
-            linear_to_tiled_##case_cpp##cpp,  FDL_MACROTILE_8_CHANNEL>(       \
-            x_start, y_start, width, height, dst, (char *)src, src_pitch,     \
-            block_stride, config);                                            \
-      }                                                                       \
-      break;
-   CASE(1)
-   CASE(2)
-   CASE(4)
-   CASE(8)
-   CASE(16)
-#undef CASE
-   default:
-      unreachable("unknown cpp");
-   }
-#endif
+
+   get_kernels(LINEAR_TO_TILED, impl)[util_logbase2(cpp)](
+      x_start, y_start, width, height, dst, (char *)src, src_pitch,
+      block_stride, config);
 }
 
 void
-fdl6_memcpy_tiled_to_linear(uint32_t x_start, uint32_t y_start,
-                            uint32_t width, uint32_t height,
-                            char *dst, const char *src,
-                            const struct fdl_layout *src_layout,
-                            unsigned src_miplevel,
-                            uint32_t dst_pitch,
-                            const struct fdl_ubwc_config *config)
+fdl6_memcpy_tiled_to_linear_impl(uint32_t x_start, uint32_t y_start,
+                                 uint32_t width, uint32_t height,
+                                 char *dst, const char *src,
+                                 const struct fdl_layout *src_layout,
+                                 unsigned src_miplevel,
+                                 uint32_t dst_pitch,
+                                 const struct fdl_ubwc_config *config,
+                                 enum fdl_tiled_memcpy_impl impl)
 {
    unsigned block_width, block_height;
    unsigned cpp = src_layout->cpp;
@@ -924,48 +1472,56 @@ fdl6_memcpy_tiled_to_linear(uint32_t x_start, uint32_t y_start,
    assert(block_size == block_width * block_height * src_layout->cpp);
    assert(config->macrotile_mode != FDL_MACROTILE_INVALID);
 
-#if USE_SLOW_PATH
-   for (uint32_t y = 0; y < height; y++) {
-      uint32_t y_block = (y + y_start) / block_height;
-      uint32_t y_pixel = (y + y_start) % block_height;
-      for (uint32_t x = 0; x < width; x++) {
-         uint32_t x_block = (x + x_start) / block_width;
-         uint32_t x_pixel = (x + x_start) % block_width;
+   impl = resolve_impl(impl);
+
+   if (impl == FDL_TILED_MEMCPY_REFERENCE) {
+      for (uint32_t y = 0; y < height; y++) {
+         uint32_t y_block = (y + y_start) / block_height;
+         uint32_t y_pixel = (y + y_start) % block_height;
+         for (uint32_t x = 0; x < width; x++) {
+            uint32_t x_block = (x + x_start) / block_width;
+            uint32_t x_pixel = (x + x_start) % block_width;
 
-	 uint32_t block_offset =
-            get_block_offset(x_block, y_block, block_stride, src_layout->cpp,
-                             config);
-	 uint32_t pixel_offset = get_pixel_offset(x_pixel, y_pixel);
+            uint32_t block_offset =
+               get_block_offset(x_block, y_block, block_stride, cpp, config);
+            uint32_t pixel_offset = get_pixel_offset(x_pixel, y_pixel);
 
-         memcpy(dst + y * dst_pitch + x * src_layout->cpp,
-                src + block_size * block_offset + src_layout->cpp * pixel_offset,
-                src_layout->cpp);
+            memcpy(dst + y * dst_pitch + x * cpp,
+                   src + block_size * block_offset + cpp * pixel_offset, cpp);
+         }
       }
+      return;
    }
-#else
-   switch (cpp) {
-#define CASE(case_cpp)                                                        \
-   case case_cpp:                                                             \
-      if (config->macrotile_mode == FDL_MACROTILE_4_CHANNEL) {                \
-         memcpy_large<case_cpp, TILED_TO_LINEAR,                              \
-            tiled_to_linear_##case_cpp##cpp, FDL_MACROTILE_4_CHANNEL>(        \
-            x_start, y_start, width, height, (char *)src, dst, dst_pitch,     \
-            block_stride, config);                                            \
-      } else {                                                                \
-         memcpy_large<case_cpp, TILED_TO_LINEAR,                              \
-            tiled_to_linear_##case_cpp##cpp, FDL_MACROTILE_8_CHANNEL>(        \
-            x_start, y_start, width, height, (char *)src, dst, dst_pitch,     \
-            block_stride, config);                                            \
-      }                                                                       \
-      break;
-   CASE(1)
-   CASE(2)
-   CASE(4)
-   CASE(8)
-   CASE(16)
-#undef CASE
-   default:
-      unreachable("unknown cpp");
-   }
-#endif
+
+   get_kernels(TILED_TO_LINEAR, impl)[util_logbase2(cpp)](
+      x_start, y_start, width, height, (char *)src, dst, dst_pitch,
+      block_stride, config);
+}
+
+void
+fdl6_memcpy_linear_to_tiled(uint32_t x_start, uint32_t y_start,
+                            uint32_t width, uint32_t height,
+                            char *dst, const char *src,
+                            const struct fdl_layout *dst_layout,
+                            unsigned dst_miplevel,
+                            uint32_t src_pitch,
+                            const struct fdl_ubwc_config *config)
+{
+   fdl6_memcpy_linear_to_tiled_impl(x_start, y_start, width, height, dst, src,
+                                    dst_layout, dst_miplevel, src_pitch,
+                                    config, FDL_TILED_MEMCPY_AUTO);
+}
+
+void
+fdl6_memcpy_tiled_to_linear(uint32_t x_start, uint32_t y_start,
+                            uint32_t width, uint32_t height,
+                            char *dst, const char *src,
+                            const struct fdl_layout *src_layout,
+                            unsigned src_miplevel,
+                            uint32_t dst_pitch,
+                            const struct fdl_ubwc_config *config)
+{
+   fdl6_memcpy_tiled_to_linear_impl(x_start, y_start, width, height, dst, src,
+                                    src_layout, src_miplevel, dst_pitch,
+                                    config, FDL_TILED_MEMCPY_AUTO);
 }
@@ -0,0 +1,121 @@
+/*
+ * Copyright © 2025 Google LLC
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Throughput benchmark for the fdl6 tiled memcpy implementations.
+ *
+ * Usage: fd6_tiled_memcpy_bench [width] [height] [iterations]
+ */
+
+#include "freedreno_layout.h"
+#include "adreno_common.xml.h"
+#include "adreno_pm4.xml.h"
+#include "a6xx.xml.h"
+
+#include "common/freedreno_dev_info.h"
+#include "util/os_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const enum pipe_format formats[] = {
+   PIPE_FORMAT_R8_UINT,
+   PIPE_FORMAT_R16_UINT,
+   PIPE_FORMAT_R32_UINT,
+   PIPE_FORMAT_R32G32_UINT,
+   PIPE_FORMAT_R32G32B32A32_UINT,
+};
+
+static double
+run(const struct fdl_layout *layout, const struct fdl_ubwc_config *config,
+    enum fdl_tiled_memcpy_impl impl, bool to_tiled, char *tiled,
+    char *linear, uint32_t linear_pitch, unsigned iterations)
+{
+   int64_t start = os_time_get_nano();
+
+   for (unsigned i = 0; i < iterations; i++) {
+      if (to_tiled) {
+         fdl6_memcpy_linear_to_tiled_impl(0, 0, layout->width0,
+                                          layout->height0, tiled, linear,
+                                          layout, 0, linear_pitch, config,
+                                          impl);
+      } else {
+         fdl6_memcpy_tiled_to_linear_impl(0, 0, layout->width0,
+                                          layout->height0, linear, tiled,
+                                          layout, 0, linear_pitch, config,
+                                          impl);
+      }
+   }
+
+   int64_t elapsed = os_time_get_nano() - start;
+   double bytes = (double)layout->width0 * layout->height0 * layout->cpp *
+                  iterations;
+   return bytes / (elapsed / 1e9) / (1024 * 1024);
+}
+
+int
+main(int argc, char **argv)
+{
+   uint32_t width = argc > 1 ? atoi(argv[1]) : 2048;
+   uint32_t height = argc > 2 ? atoi(argv[2]) : 2048;
+   unsigned iterations = argc > 3 ? atoi(argv[3]) : 20;
+
+   struct fd_dev_id a660_dev_id = {
+      .gpu_id = 660,
+   };
+   const struct fd_dev_info *dev_info = fd_dev_info_raw(&a660_dev_id);
+   const struct fdl_ubwc_config config = {
+      .highest_bank_bit = 15,
+      .bank_swizzle_levels = 0x6,
+      .macrotile_mode = FDL_MACROTILE_8_CHANNEL,
+   };
+
+   printf("%ux%u, %u iterations, MiB/s\n", width, height, iterations);
+   printf("%-8s %-10s %12s %12s\n", "format", "impl", "to tiled",
+          "to linear");
+
+   for (int f = 0; f < ARRAY_SIZE(formats); f++) {
+      struct fdl_layout layout = {
+         .tile_mode = TILE6_3,
+      };
+      fdl6_layout(&layout, dev_info, formats[f], 1, width, height, 1, 1, 1,
+                  false, false, NULL);
+
+      uint32_t linear_pitch = width * layout.cpp;
+      char *linear = malloc((size_t)linear_pitch * height);
+      char *tiled = malloc(layout.size);
+      memset(linear, 0x5a, (size_t)linear_pitch * height);
+      memset(tiled, 0xa5, layout.size);
+
+      for (int impl = FDL_TILED_MEMCPY_REFERENCE;
+           impl < FDL_TILED_MEMCPY_IMPL_COUNT; impl++) {
+         if (!fdl6_tiled_memcpy_impl_supported(
+                (enum fdl_tiled_memcpy_impl)impl))
+            continue;
+
+         /* The reference path is far slower, don't wait forever on it. */
+         unsigned impl_iterations =
+            impl == FDL_TILED_MEMCPY_REFERENCE ? MAX2(iterations / 10, 1)
+                                               : iterations;
+
+         double to_tiled =
+            run(&layout, &config, (enum fdl_tiled_memcpy_impl)impl, true,
+                tiled, linear, linear_pitch, impl_iterations);
+         double to_linear =
+            run(&layout, &config, (enum fdl_tiled_memcpy_impl)impl, false,
+                tiled, linear, linear_pitch, impl_iterations);
+
+         printf("%-8s %-10s %12.1f %12.1f\n",
+                util_format_short_name(formats[f]),
+                fdl6_tiled_memcpy_impl_name((enum fdl_tiled_memcpy_impl)impl),
+                to_tiled, to_linear);
+      }
+
+      free(linear);
+      free(tiled);
+   }
+
+   return 0;
+}
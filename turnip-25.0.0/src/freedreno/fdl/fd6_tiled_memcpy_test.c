@@ -0,0 +1,229 @@
+/*
+ * Copyright © 2025 Google LLC
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Checks every optimized fdl6 tiled memcpy implementation supported by the
+ * host CPU against the per-pixel reference implementation, for all cpp's,
+ * macrotile modes and bank swizzling configs, using a mix of aligned and
+ * misaligned copy regions.
+ */
+
+#include "freedreno_layout.h"
+#include "adreno_common.xml.h"
+#include "adreno_pm4.xml.h"
+#include "a6xx.xml.h"
+
+#include "common/freedreno_dev_info.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const enum pipe_format formats[] = {
+   PIPE_FORMAT_R8_UINT,
+   PIPE_FORMAT_R16_UINT,
+   PIPE_FORMAT_R32_UINT,
+   PIPE_FORMAT_R32G32_UINT,
+   PIPE_FORMAT_R32G32B32A32_UINT,
+};
+
+static const struct {
+   uint32_t width, height;
+} sizes[] = {
+   {1, 1},
+   {17, 5},
+   {64, 16},
+   {100, 37},
+   {256, 64},
+   {513, 130},
+};
+
+static const unsigned highest_bank_bits[] = { 13, 14, 15, 16 };
+static const unsigned bank_swizzle_levels[] = { 0x0, 0x1, 0x6, 0x7 };
+
+static uint32_t rand_state = 0x12345678;
+
+static uint32_t
+test_rand(void)
+{
+   /* xorshift32, so that failures are reproducible across platforms */
+   rand_state ^= rand_state << 13;
+   rand_state ^= rand_state >> 17;
+   rand_state ^= rand_state << 5;
+   return rand_state;
+}
+
+static void
+fill_random(char *buf, size_t size)
+{
+   for (size_t i = 0; i < size; i++)
+      buf[i] = test_rand();
+}
+
+struct region {
+   uint32_t x, y, width, height;
+};
+
+static unsigned
+get_regions(uint32_t width, uint32_t height, struct region *regions)
+{
+   unsigned count = 0;
+
+   regions[count++] = (struct region) { 0, 0, width, height };
+
+   if (width > 3 && height > 3) {
+      regions[count++] =
+         (struct region) { 1, 3, width - 1, height - 3 };
+      regions[count++] =
+         (struct region) { 3, 1, width - 3, height - 2 };
+   }
+
+   for (unsigned i = 0; i < 4; i++) {
+      uint32_t x = test_rand() % width;
+      uint32_t y = test_rand() % height;
+      regions[count++] = (struct region) {
+         x, y, 1 + test_rand() % (width - x), 1 + test_rand() % (height - y),
+      };
+   }
+
+   return count;
+}
+
+static bool
+test_impl(const struct fdl_layout *layout,
+          const struct fdl_ubwc_config *config,
+          enum fdl_tiled_memcpy_impl impl, const struct region *region)
+{
+   uint32_t cpp = layout->cpp;
+   /* Use a deliberately unaligned pitch to catch kernels assuming aligned
+    * linear rows.
+    */
+   uint32_t linear_pitch = region->width * cpp + 3;
+   size_t linear_size = (size_t)linear_pitch * region->height;
+   size_t tiled_size = layout->size;
+   bool ok = true;
+
+   char *linear = malloc(linear_size);
+   char *tiled = malloc(tiled_size);
+   char *ref = malloc(MAX2(linear_size, tiled_size));
+   char *result = malloc(MAX2(linear_size, tiled_size));
+
+   fill_random(linear, linear_size);
+   fill_random(tiled, tiled_size);
+
+   /* linear -> tiled, on top of existing contents so that writes outside
+    * the region are caught.
+    */
+   memcpy(ref, tiled, tiled_size);
+   memcpy(result, tiled, tiled_size);
+   fdl6_memcpy_linear_to_tiled_impl(region->x, region->y, region->width,
+                                    region->height, ref, linear, layout, 0,
+                                    linear_pitch, config,
+                                    FDL_TILED_MEMCPY_REFERENCE);
+   fdl6_memcpy_linear_to_tiled_impl(region->x, region->y, region->width,
+                                    region->height, result, linear, layout, 0,
+                                    linear_pitch, config, impl);
+   if (memcmp(ref, result, tiled_size)) {
+      fprintf(stderr, "%s: linear to tiled mismatch\n",
+              fdl6_tiled_memcpy_impl_name(impl));
+      ok = false;
+   }
+
+   /* tiled -> linear */
+   fill_random(ref, linear_size);
+   memcpy(result, ref, linear_size);
+   fdl6_memcpy_tiled_to_linear_impl(region->x, region->y, region->width,
+                                    region->height, ref, tiled, layout, 0,
+                                    linear_pitch, config,
+                                    FDL_TILED_MEMCPY_REFERENCE);
+   fdl6_memcpy_tiled_to_linear_impl(region->x, region->y, region->width,
+                                    region->height, result, tiled, layout, 0,
+                                    linear_pitch, config, impl);
+   if (memcmp(ref, result, linear_size)) {
+      fprintf(stderr, "%s: tiled to linear mismatch\n",
+              fdl6_tiled_memcpy_impl_name(impl));
+      ok = false;
+   }
+
+   if (!ok) {
+      fprintf(stderr,
+              "  %s %ux%u, region %u,%u %ux%u, macrotile mode %u, "
+              "hbb %u, bank swizzle levels 0x%x\n",
+              util_format_short_name(layout->format), layout->width0,
+              layout->height0, region->x, region->y, region->width,
+              region->height, config->macrotile_mode,
+              config->highest_bank_bit, config->bank_swizzle_levels);
+   }
+
+   free(linear);
+   free(tiled);
+   free(ref);
+   free(result);
+
+   return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+   struct fd_dev_id a660_dev_id = {
+      .gpu_id = 660,
+   };
+   const struct fd_dev_info *dev_info = fd_dev_info_raw(&a660_dev_id);
+   unsigned tested = 0;
+   int ret = 0;
+
+   for (int f = 0; f < ARRAY_SIZE(formats); f++) {
+      for (int s = 0; s < ARRAY_SIZE(sizes); s++) {
+         struct fdl_layout layout = {
+            .tile_mode = TILE6_3,
+         };
+         fdl6_layout(&layout, dev_info, formats[f], 1, sizes[s].width,
+                     sizes[s].height, 1, 1, 1, false, false, NULL);
+
+         struct region regions[8];
+         unsigned num_regions =
+            get_regions(sizes[s].width, sizes[s].height, regions);
+
+         for (int mode = FDL_MACROTILE_4_CHANNEL;
+              mode <= FDL_MACROTILE_8_CHANNEL; mode++) {
+            for (int h = 0; h < ARRAY_SIZE(highest_bank_bits); h++) {
+               for (int l = 0; l < ARRAY_SIZE(bank_swizzle_levels); l++) {
+                  struct fdl_ubwc_config config = {
+                     .highest_bank_bit = highest_bank_bits[h],
+                     .bank_swizzle_levels = bank_swizzle_levels[l],
+                     .macrotile_mode = (enum fdl_macrotile_mode)mode,
+                  };
+
+                  for (int impl = FDL_TILED_MEMCPY_GENERIC;
+                       impl < FDL_TILED_MEMCPY_IMPL_COUNT; impl++) {
+                     if (!fdl6_tiled_memcpy_impl_supported(
+                            (enum fdl_tiled_memcpy_impl)impl))
+                        continue;
+
+                     for (unsigned r = 0; r < num_regions; r++) {
+                        if (!test_impl(&layout, &config,
+                                       (enum fdl_tiled_memcpy_impl)impl,
+                                       &regions[r]))
+                           ret = 1;
+                        tested++;
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   for (int impl = FDL_TILED_MEMCPY_GENERIC;
+        impl < FDL_TILED_MEMCPY_IMPL_COUNT; impl++) {
+      printf("%s: %s\n",
+             fdl6_tiled_memcpy_impl_name((enum fdl_tiled_memcpy_impl)impl),
+             fdl6_tiled_memcpy_impl_supported((enum fdl_tiled_memcpy_impl)impl)
+                ? "tested" : "not supported");
+   }
+   printf("%u copies checked\n", tested);
+
+   return ret;
+}
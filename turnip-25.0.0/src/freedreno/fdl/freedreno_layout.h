@@ -355,6 +355,46 @@ struct fdl_ubwc_config {
    enum fdl_macrotile_mode macrotile_mode;
 };
 
+/* Implementations of the tiled memcpy. FDL_TILED_MEMCPY_AUTO picks the
+ * fastest one the CPU supports, the others are only meant for testing and
+ * benchmarking. FDL_TILED_MEMCPY_REFERENCE is a slow per-pixel loop and
+ * FDL_TILED_MEMCPY_GENERIC uses the portable (or NEON on aarch64) kernels.
+ */
+enum fdl_tiled_memcpy_impl {
+   FDL_TILED_MEMCPY_AUTO,
+   FDL_TILED_MEMCPY_REFERENCE,
+   FDL_TILED_MEMCPY_GENERIC,
+   FDL_TILED_MEMCPY_SSE2,
+   FDL_TILED_MEMCPY_AVX2,
+   FDL_TILED_MEMCPY_IMPL_COUNT,
+};
+
+bool
+fdl6_tiled_memcpy_impl_supported(enum fdl_tiled_memcpy_impl impl);
+
+const char *
+fdl6_tiled_memcpy_impl_name(enum fdl_tiled_memcpy_impl impl);
+
+void
+fdl6_memcpy_linear_to_tiled_impl(uint32_t x_start, uint32_t y_start,
+                                 uint32_t width, uint32_t height,
+                                 char *dst, const char *src,
+                                 const struct fdl_layout *dst_layout,
+                                 unsigned dst_miplevel,
+                                 uint32_t src_pitch,
+                                 const struct fdl_ubwc_config *config,
+                                 enum fdl_tiled_memcpy_impl impl);
+
+void
+fdl6_memcpy_tiled_to_linear_impl(uint32_t x_start, uint32_t y_start,
+                                 uint32_t width, uint32_t height,
+                                 char *dst, const char *src,
+                                 const struct fdl_layout *src_layout,
+                                 unsigned src_miplevel,
+                                 uint32_t dst_pitch,
+                                 const struct fdl_ubwc_config *config,
+                                 enum fdl_tiled_memcpy_impl impl);
+
 void
 fdl6_memcpy_linear_to_tiled(uint32_t x_start, uint32_t y_start,
                             uint32_t width, uint32_t height,
@@ -2097,9 +2097,21 @@ __ssa_srcp_n(struct ir3_instruction *instr, unsigned n)
 #define foreach_array_safe(__array, __list)                                    \
    list_for_each_entry_safe (struct ir3_array, __array, __list, node)
 
+/* pass timing, see IR3_SHADER_DEBUG=passtime: */
+struct ir3_passtime {
+   int64_t start_ns;
+   int64_t start_heap;
+};
+
+void ir3_passtime_begin(struct ir3_passtime *pt);
+void ir3_passtime_end(struct ir3_passtime *pt, const char *pass);
+
 #define IR3_PASS(ir, pass, ...)                                                \
    ({                                                                          \
+      struct ir3_passtime _pt;                                                 \
+      ir3_passtime_begin(&_pt);                                                \
       bool progress = pass(ir, ##__VA_ARGS__);                                 \
+      ir3_passtime_end(&_pt, #pass);                                           \
       if (progress) {                                                          \
          ir3_debug_print(ir, "AFTER: " #pass);                                 \
          ir3_validate(ir);                                                     \
@@ -370,6 +370,7 @@ enum ir3_shader_debug {
    IR3_DBG_RAMSGS = BITFIELD_BIT(21),
    IR3_DBG_NOALIASTEX = BITFIELD_BIT(22),
    IR3_DBG_NOALIASRT = BITFIELD_BIT(23),
+   IR3_DBG_PASSTIME = BITFIELD_BIT(24),
 };
 
 extern enum ir3_shader_debug ir3_shader_debug;
@@ -425,7 +426,8 @@ ir3_shader_debug_hash_key()
       ~(IR3_DBG_SHADER_VS | IR3_DBG_SHADER_TCS | IR3_DBG_SHADER_TES |
         IR3_DBG_SHADER_GS | IR3_DBG_SHADER_FS | IR3_DBG_SHADER_CS |
         IR3_DBG_DISASM | IR3_DBG_OPTMSGS | IR3_DBG_NOCACHE |
-        IR3_DBG_SHADER_INTERNAL | IR3_DBG_SCHEDMSGS | IR3_DBG_RAMSGS));
+        IR3_DBG_SHADER_INTERNAL | IR3_DBG_SCHEDMSGS | IR3_DBG_RAMSGS |
+        IR3_DBG_PASSTIME));
 }
 
 ENDC;
@@ -5560,6 +5560,7 @@ ir3_compile_shader_nir(struct ir3_compiler *compiler,
                        struct ir3_shader_variant *so)
 {
    struct ir3_context *ctx;
+   struct ir3_passtime pt;
    struct ir3 *ir;
    int ret = 0, max_bary;
    bool progress;
@@ -5575,7 +5576,9 @@ ir3_compile_shader_nir(struct ir3_compiler *compiler,
       goto out;
    }
 
+   ir3_passtime_begin(&pt);
    emit_instructions(ctx);
+   ir3_passtime_end(&pt, "emit_instructions");
 
    if (ctx->error) {
       DBG("EMIT failed!");
@@ -5808,7 +5811,9 @@ ir3_compile_shader_nir(struct ir3_compiler *compiler,
    /* At this point, all the dead code should be long gone: */
    assert(!IR3_PASS(ir, ir3_dce, so));
 
+   ir3_passtime_begin(&pt);
    ret = ir3_sched(ir);
+   ir3_passtime_end(&pt, "ir3_sched");
    if (ret) {
       DBG("SCHED failed!");
       goto out;
@@ -5866,7 +5871,9 @@ ir3_compile_shader_nir(struct ir3_compiler *compiler,
    }
 
    IR3_PASS(ir, ir3_cleanup_rpt, so);
+   ir3_passtime_begin(&pt);
    ret = ir3_ra(so);
+   ir3_passtime_end(&pt, "ir3_ra");
 
    if (ret) {
       mesa_loge("ir3_ra() failed!");
@@ -17,54 +17,60 @@
  *   treated very differently by RA at the beginning of a block.
  */
 
-static bool
-compute_block_liveness(struct ir3_liveness *live, struct ir3_block *block,
-                       BITSET_WORD *tmp_live, unsigned bitset_words,
-                       reg_filter_cb filter_src, reg_filter_cb filter_dst)
-{
-   memcpy(tmp_live, live->live_out[block->index],
-          bitset_words * sizeof(BITSET_WORD));
+/* Liveness is computed in two steps. First, each block is summarized by the
+ * values it uses before defining them (gen) and the values it defines
+ * (kill), so that finding the fixed point only takes bitset operations:
+ *
+ *    live_in = gen | (live_out & ~kill)
+ *
+ * and only blocks whose live_out changed are revisited. Then the
+ * instructions are walked once more to set the kill/unused flags from the
+ * final live_out. This gives the same result as iterating over the
+ * instructions until nothing changes, but huge shaders with deep loop nests
+ * no longer have every instruction visited once per iteration.
+ */
 
-   /* Process instructions */
+static void
+summarize_block(struct ir3_block *block, BITSET_WORD *gen, BITSET_WORD *kill,
+                reg_filter_cb filter_src, reg_filter_cb filter_dst)
+{
    foreach_instr_rev (instr, &block->instr_list) {
       foreach_dst_if (dst, instr, filter_dst) {
-         if (BITSET_TEST(tmp_live, dst->name))
-            dst->flags &= ~IR3_REG_UNUSED;
-         else
-            dst->flags |= IR3_REG_UNUSED;
-         BITSET_CLEAR(tmp_live, dst->name);
+         BITSET_CLEAR(gen, dst->name);
+         BITSET_SET(kill, dst->name);
       }
 
       /* Phi node uses occur after the predecessor block */
       if (instr->opc != OPC_META_PHI) {
          foreach_src_if (src, instr, filter_src) {
-            if (BITSET_TEST(tmp_live, src->def->name))
-               src->flags &= ~IR3_REG_KILL;
-            else
-               src->flags |= IR3_REG_KILL;
-         }
-
-         foreach_src_if (src, instr, filter_src) {
-            if (BITSET_TEST(tmp_live, src->def->name))
-               src->flags &= ~IR3_REG_FIRST_KILL;
-            else
-               src->flags |= IR3_REG_FIRST_KILL;
             assert(src->def->name != 0);
-            BITSET_SET(tmp_live, src->def->name);
+            BITSET_SET(gen, src->def->name);
          }
       }
    }
+}
 
-   memcpy(live->live_in[block->index], tmp_live,
-          bitset_words * sizeof(BITSET_WORD));
+static void
+propagate_block_liveness(struct ir3_liveness *live, struct ir3_block *block,
+                         const BITSET_WORD *gen, const BITSET_WORD *kill,
+                         const BITSET_WORD *shared, BITSET_WORD *dirty,
+                         unsigned bitset_words, reg_filter_cb filter_dst)
+{
+   BITSET_WORD *live_in = live->live_in[block->index];
+   const BITSET_WORD *live_out = live->live_out[block->index];
+
+   for (unsigned j = 0; j < bitset_words; j++)
+      live_in[j] = gen[j] | (live_out[j] & ~kill[j]);
 
-   bool progress = false;
    for (unsigned i = 0; i < block->predecessors_count; i++) {
       const struct ir3_block *pred = block->predecessors[i];
+      BITSET_WORD *pred_live_out = live->live_out[pred->index];
+      bool progress = false;
+
       for (unsigned j = 0; j < bitset_words; j++) {
-         if (tmp_live[j] & ~live->live_out[pred->index][j])
+         if (live_in[j] & ~pred_live_out[j])
             progress = true;
-         live->live_out[pred->index][j] |= tmp_live[j];
+         pred_live_out[j] |= live_in[j];
       }
 
       /* Process phi sources. */
@@ -76,28 +82,72 @@ compute_block_liveness(struct ir3_liveness *live, struct ir3_block *block,
          if (!filter_dst(phi->srcs[i]))
             continue;
          unsigned name = phi->srcs[i]->def->name;
-         if (!BITSET_TEST(live->live_out[pred->index], name)) {
+         if (!BITSET_TEST(pred_live_out, name)) {
             progress = true;
-            BITSET_SET(live->live_out[pred->index], name);
+            BITSET_SET(pred_live_out, name);
          }
       }
+
+      if (progress)
+         BITSET_SET(dirty, pred->index);
    }
 
    for (unsigned i = 0; i < block->physical_predecessors_count; i++) {
       const struct ir3_block *pred = block->physical_predecessors[i];
-      unsigned name;
-      BITSET_FOREACH_SET (name, tmp_live, live->definitions_count) {
-         struct ir3_register *reg = live->definitions[name];
-         if (!(reg->flags & IR3_REG_SHARED))
-            continue;
-         if (!BITSET_TEST(live->live_out[pred->index], name)) {
+      BITSET_WORD *pred_live_out = live->live_out[pred->index];
+      bool progress = false;
+
+      for (unsigned j = 0; j < bitset_words; j++) {
+         BITSET_WORD shared_live = live_in[j] & shared[j];
+         if (shared_live & ~pred_live_out[j])
             progress = true;
-            BITSET_SET(live->live_out[pred->index], name);
+         pred_live_out[j] |= shared_live;
+      }
+
+      if (progress)
+         BITSET_SET(dirty, pred->index);
+   }
+}
+
+static void
+annotate_block_liveness(struct ir3_liveness *live, struct ir3_block *block,
+                        BITSET_WORD *tmp_live, unsigned bitset_words,
+                        reg_filter_cb filter_src, reg_filter_cb filter_dst)
+{
+   memcpy(tmp_live, live->live_out[block->index],
+          bitset_words * sizeof(BITSET_WORD));
+
+   /* Process instructions */
+   foreach_instr_rev (instr, &block->instr_list) {
+      foreach_dst_if (dst, instr, filter_dst) {
+         if (BITSET_TEST(tmp_live, dst->name))
+            dst->flags &= ~IR3_REG_UNUSED;
+         else
+            dst->flags |= IR3_REG_UNUSED;
+         BITSET_CLEAR(tmp_live, dst->name);
+      }
+
+      /* Phi node uses occur after the predecessor block */
+      if (instr->opc != OPC_META_PHI) {
+         foreach_src_if (src, instr, filter_src) {
+            if (BITSET_TEST(tmp_live, src->def->name))
+               src->flags &= ~IR3_REG_KILL;
+            else
+               src->flags |= IR3_REG_KILL;
+         }
+
+         foreach_src_if (src, instr, filter_src) {
+            if (BITSET_TEST(tmp_live, src->def->name))
+               src->flags &= ~IR3_REG_FIRST_KILL;
+            else
+               src->flags |= IR3_REG_FIRST_KILL;
+            BITSET_SET(tmp_live, src->def->name);
          }
       }
    }
 
-   return progress;
+   assert(!memcmp(tmp_live, live->live_in[block->index],
+                  bitset_words * sizeof(BITSET_WORD)));
 }
 
 struct ir3_liveness *
@@ -138,15 +188,50 @@ ir3_calc_liveness_for(void *mem_ctx, struct ir3 *ir, reg_filter_cb filter_src,
          rzalloc_array(live, BITSET_WORD, bitset_words);
    }
 
+   void *summary_ctx = ralloc_context(NULL);
+   BITSET_WORD **gen = ralloc_array(summary_ctx, BITSET_WORD *, block_count);
+   BITSET_WORD **kill = ralloc_array(summary_ctx, BITSET_WORD *, block_count);
+   BITSET_WORD *shared =
+      rzalloc_array(summary_ctx, BITSET_WORD, bitset_words);
+   BITSET_WORD *dirty =
+      rzalloc_array(summary_ctx, BITSET_WORD, BITSET_WORDS(block_count));
+
+   for (unsigned name = 1; name < live->definitions_count; name++) {
+      if (live->definitions[name]->flags & IR3_REG_SHARED)
+         BITSET_SET(shared, name);
+   }
+
+   foreach_block (block, &ir->block_list) {
+      gen[block->index] = rzalloc_array(summary_ctx, BITSET_WORD, bitset_words);
+      kill[block->index] =
+         rzalloc_array(summary_ctx, BITSET_WORD, bitset_words);
+      summarize_block(block, gen[block->index], kill[block->index],
+                      filter_src, filter_dst);
+      BITSET_SET(dirty, block->index);
+   }
+
    bool progress = true;
    while (progress) {
       progress = false;
       foreach_block_rev (block, &ir->block_list) {
-         progress |= compute_block_liveness(live, block, tmp_live, bitset_words,
-                                            filter_src, filter_dst);
+         if (!BITSET_TEST(dirty, block->index))
+            continue;
+
+         BITSET_CLEAR(dirty, block->index);
+         progress = true;
+         propagate_block_liveness(live, block, gen[block->index],
+                                  kill[block->index], shared, dirty,
+                                  bitset_words, filter_dst);
       }
    }
 
+   ralloc_free(summary_ctx);
+
+   foreach_block (block, &ir->block_list) {
+      annotate_block_liveness(live, block, tmp_live, bitset_words, filter_src,
+                              filter_dst);
+   }
+
    return live;
 }
 
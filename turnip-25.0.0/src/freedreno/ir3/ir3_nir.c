@@ -294,11 +294,20 @@ ir3_get_variable_size_align_bytes(const glsl_type *type, unsigned *size, unsigne
 #define OPT(nir, pass, ...)                                                    \
    ({                                                                          \
       bool this_progress = false;                                              \
+      struct ir3_passtime _pt;                                                 \
+      ir3_passtime_begin(&_pt);                                                \
       NIR_PASS(this_progress, nir, pass, ##__VA_ARGS__);                       \
+      ir3_passtime_end(&_pt, #pass);                                           \
       this_progress;                                                           \
    })
 
-#define OPT_V(nir, pass, ...) NIR_PASS_V(nir, pass, ##__VA_ARGS__)
+#define OPT_V(nir, pass, ...)                                                  \
+   do {                                                                        \
+      struct ir3_passtime _pt;                                                 \
+      ir3_passtime_begin(&_pt);                                                \
+      NIR_PASS_V(nir, pass, ##__VA_ARGS__);                                    \
+      ir3_passtime_end(&_pt, #pass);                                           \
+   } while (0)
 
 bool
 ir3_optimize_loop(struct ir3_compiler *compiler,
@@ -486,15 +495,15 @@ ir3_nir_lower_io_to_temporaries(nir_shader *s)
    bool lower_output = s->info.stage != MESA_SHADER_TESS_CTRL &&
                        s->info.stage != MESA_SHADER_GEOMETRY;
    if (lower_input || lower_output) {
-      NIR_PASS_V(s, nir_lower_io_to_temporaries, nir_shader_get_entrypoint(s),
-                 lower_output, lower_input);
+      OPT_V(s, nir_lower_io_to_temporaries, nir_shader_get_entrypoint(s),
+            lower_output, lower_input);
 
       /* nir_lower_io_to_temporaries() creates global variables and copy
        * instructions which need to be cleaned up.
        */
-      NIR_PASS_V(s, nir_split_var_copies);
-      NIR_PASS_V(s, nir_lower_var_copies);
-      NIR_PASS_V(s, nir_lower_global_vars_to_local);
+      OPT_V(s, nir_split_var_copies);
+      OPT_V(s, nir_lower_var_copies);
+      OPT_V(s, nir_lower_global_vars_to_local);
    }
 
    /* Regardless of the above, we need to lower indirect references to
@@ -507,7 +516,7 @@ ir3_nir_lower_io_to_temporaries(nir_shader *s)
     * Using temporaries would be slightly better but
     * nir_lower_io_to_temporaries currently doesn't support TCS i/o.
     */
-   NIR_PASS_V(s, nir_lower_indirect_derefs, 0, UINT32_MAX);
+   OPT_V(s, nir_lower_indirect_derefs, 0, UINT32_MAX);
 }
 
 /**
@@ -578,10 +587,10 @@ ir3_finalize_nir(struct ir3_compiler *compiler,
    }
 
    if (s->info.stage == MESA_SHADER_GEOMETRY)
-      NIR_PASS_V(s, ir3_nir_lower_gs);
+      OPT_V(s, ir3_nir_lower_gs);
 
-   NIR_PASS_V(s, nir_lower_frexp);
-   NIR_PASS_V(s, nir_lower_amul, ir3_glsl_type_size);
+   OPT_V(s, nir_lower_frexp);
+   OPT_V(s, nir_lower_amul, ir3_glsl_type_size);
 
    OPT_V(s, nir_lower_wrmasks, should_split_wrmask, s);
 
@@ -752,24 +761,24 @@ ir3_nir_post_finalize(struct ir3_shader *shader)
 
    MESA_TRACE_FUNC();
 
-   NIR_PASS_V(s, nir_lower_io, nir_var_shader_in | nir_var_shader_out,
-              ir3_glsl_type_size, nir_lower_io_lower_64bit_to_32 |
-              nir_lower_io_use_interpolated_input_intrinsics);
+   OPT_V(s, nir_lower_io, nir_var_shader_in | nir_var_shader_out,
+         ir3_glsl_type_size, nir_lower_io_lower_64bit_to_32 |
+         nir_lower_io_use_interpolated_input_intrinsics);
 
    if (s->info.stage == MESA_SHADER_FRAGMENT) {
       /* NOTE: lower load_barycentric_at_sample first, since it
        * produces load_barycentric_at_offset:
        */
-      NIR_PASS_V(s, ir3_nir_lower_load_barycentric_at_sample);
-      NIR_PASS_V(s, ir3_nir_lower_load_barycentric_at_offset);
-      NIR_PASS_V(s, ir3_nir_move_varying_inputs);
-      NIR_PASS_V(s, nir_lower_fb_read);
-      NIR_PASS_V(s, ir3_nir_lower_layer_id);
-      NIR_PASS_V(s, ir3_nir_lower_frag_shading_rate);
+      OPT_V(s, ir3_nir_lower_load_barycentric_at_sample);
+      OPT_V(s, ir3_nir_lower_load_barycentric_at_offset);
+      OPT_V(s, ir3_nir_move_varying_inputs);
+      OPT_V(s, nir_lower_fb_read);
+      OPT_V(s, ir3_nir_lower_layer_id);
+      OPT_V(s, ir3_nir_lower_frag_shading_rate);
    }
 
    if (s->info.stage == MESA_SHADER_VERTEX || s->info.stage == MESA_SHADER_GEOMETRY) {
-      NIR_PASS_V(s, ir3_nir_lower_primitive_shading_rate);
+      OPT_V(s, ir3_nir_lower_primitive_shading_rate);
    }
 
    if (compiler->gen >= 6 && s->info.stage == MESA_SHADER_FRAGMENT &&
@@ -801,14 +810,14 @@ ir3_nir_post_finalize(struct ir3_shader *shader)
       }
 
       if (mediump_varyings) {
-         NIR_PASS_V(s, nir_lower_mediump_io,
-                  nir_var_shader_in,
-                  mediump_varyings,
-                  false);
+         OPT_V(s, nir_lower_mediump_io,
+               nir_var_shader_in,
+               mediump_varyings,
+               false);
       }
 
       /* This should come after input lowering, to opportunistically lower non-mediump outputs. */
-      NIR_PASS_V(s, nir_lower_mediump_io, nir_var_shader_out, 0, false);
+      OPT_V(s, nir_lower_mediump_io, nir_var_shader_out, 0, false);
    }
 
    {
@@ -853,7 +862,7 @@ ir3_nir_post_finalize(struct ir3_shader *shader)
    if ((s->info.stage == MESA_SHADER_COMPUTE) ||
        (s->info.stage == MESA_SHADER_KERNEL)) {
       bool progress = false;
-      NIR_PASS(progress, s, ir3_nir_lower_subgroup_id_cs, shader);
+      progress |= OPT(s, ir3_nir_lower_subgroup_id_cs, shader);
 
       if (s->info.derivative_group == DERIVATIVE_GROUP_LINEAR)
          shader->cs.force_linear_dispatch = true;
@@ -862,7 +871,7 @@ ir3_nir_post_finalize(struct ir3_shader *shader)
        * we need to lower again.
        */
       if (progress)
-         NIR_PASS_V(s, nir_lower_compute_system_values, NULL);
+         OPT_V(s, nir_lower_compute_system_values, NULL);
    }
 
    /* we cannot ensure that ir3_finalize_nir() is only called once, so
@@ -874,12 +883,12 @@ ir3_nir_post_finalize(struct ir3_shader *shader)
       .lower_cube_size = true,
       .lower_image_samples_to_one = true
    };
-   NIR_PASS_V(s, nir_lower_image, &lower_image_opts);
+   OPT_V(s, nir_lower_image, &lower_image_opts);
 
    const nir_lower_idiv_options lower_idiv_options = {
       .allow_fp16 = true,
    };
-   NIR_PASS_V(s, nir_lower_idiv, &lower_idiv_options); /* idiv generated by cube lowering */
+   OPT_V(s, nir_lower_idiv, &lower_idiv_options); /* idiv generated by cube lowering */
 
 
    /* The resinfo opcode returns the size in dwords on a4xx */
@@ -1006,26 +1015,26 @@ ir3_nir_lower_variant(struct ir3_shader_variant *so,
    if (so->key.has_gs || so->key.tessellation) {
       switch (so->type) {
       case MESA_SHADER_VERTEX:
-         NIR_PASS_V(s, ir3_nir_lower_to_explicit_output, so,
-                    so->key.tessellation);
+         OPT_V(s, ir3_nir_lower_to_explicit_output, so,
+               so->key.tessellation);
          progress = true;
          break;
       case MESA_SHADER_TESS_CTRL:
-         NIR_PASS_V(s, nir_lower_io_to_scalar,
-                     nir_var_shader_in | nir_var_shader_out, NULL, NULL);
-         NIR_PASS_V(s, ir3_nir_lower_tess_ctrl, so, so->key.tessellation);
-         NIR_PASS_V(s, ir3_nir_lower_to_explicit_input, so);
+         OPT_V(s, nir_lower_io_to_scalar,
+               nir_var_shader_in | nir_var_shader_out, NULL, NULL);
+         OPT_V(s, ir3_nir_lower_tess_ctrl, so, so->key.tessellation);
+         OPT_V(s, ir3_nir_lower_to_explicit_input, so);
          progress = true;
          break;
       case MESA_SHADER_TESS_EVAL:
-         NIR_PASS_V(s, ir3_nir_lower_tess_eval, so, so->key.tessellation);
+         OPT_V(s, ir3_nir_lower_tess_eval, so, so->key.tessellation);
          if (so->key.has_gs)
-            NIR_PASS_V(s, ir3_nir_lower_to_explicit_output, so,
-                       so->key.tessellation);
+            OPT_V(s, ir3_nir_lower_to_explicit_output, so,
+                  so->key.tessellation);
          progress = true;
          break;
       case MESA_SHADER_GEOMETRY:
-         NIR_PASS_V(s, ir3_nir_lower_to_explicit_input, so);
+         OPT_V(s, ir3_nir_lower_to_explicit_input, so);
          progress = true;
          break;
       default:
@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2025 Google LLC
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "util/detect_os.h"
+
+#if defined(__GLIBC__) || DETECT_OS_ANDROID
+#include <malloc.h>
+#endif
+
+#include "util/hash_table.h"
+#include "util/log.h"
+#include "util/os_time.h"
+#include "util/simple_mtx.h"
+#include "util/u_dynarray.h"
+
+#include "ir3_compiler.h"
+
+/* IR3_SHADER_DEBUG=passtime accumulates the wall time and the heap growth of
+ * every ir3 and NIR pass run by the compiler over the whole process, and
+ * prints them sorted by total time at exit.
+ *
+ * Heap growth is sampled from the allocator statistics, which are process
+ * wide, so with several compiler threads it also includes allocations made
+ * by the other threads in the meantime. Passes run from within other passes
+ * (like ir3_spill inside ir3_ra) are accounted to both.
+ */
+
+struct ir3_passtime_entry {
+   const char *pass;
+   uint64_t calls;
+   int64_t total_ns;
+   int64_t max_ns;
+   int64_t heap_bytes;
+};
+
+static simple_mtx_t passtime_lock = SIMPLE_MTX_INITIALIZER;
+static struct hash_table *passtime_table;
+
+static int64_t
+heap_size(void)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+   return mallinfo2().uordblks;
+#elif DETECT_OS_ANDROID
+   return mallinfo().uordblks;
+#else
+   return 0;
+#endif
+}
+
+static int
+entry_compare(const void *_a, const void *_b)
+{
+   const struct ir3_passtime_entry *a = *(const struct ir3_passtime_entry **)_a;
+   const struct ir3_passtime_entry *b = *(const struct ir3_passtime_entry **)_b;
+
+   if (a->total_ns != b->total_ns)
+      return a->total_ns < b->total_ns ? 1 : -1;
+   return strcmp(a->pass, b->pass);
+}
+
+static void
+ir3_passtime_dump(void)
+{
+   struct util_dynarray entries;
+   int64_t total_ns = 0;
+
+   simple_mtx_lock(&passtime_lock);
+
+   util_dynarray_init(&entries, NULL);
+   hash_table_foreach (passtime_table, he) {
+      struct ir3_passtime_entry *entry = he->data;
+      util_dynarray_append(&entries, struct ir3_passtime_entry *, entry);
+      total_ns += entry->total_ns;
+   }
+
+   qsort(entries.data,
+         util_dynarray_num_elements(&entries, struct ir3_passtime_entry *),
+         sizeof(struct ir3_passtime_entry *), entry_compare);
+
+   mesa_logi("%-40s %8s %12s %6s %10s %10s %12s", "pass", "calls",
+             "total ms", "%", "avg us", "max us", "heap KiB");
+
+   util_dynarray_foreach (&entries, struct ir3_passtime_entry *, e) {
+      const struct ir3_passtime_entry *entry = *e;
+      mesa_logi("%-40s %8" PRIu64 " %12.3f %6.2f %10.1f %10.1f %12.1f",
+                entry->pass, entry->calls, entry->total_ns / 1000000.0,
+                total_ns ? 100.0 * entry->total_ns / total_ns : 0.0,
+                entry->total_ns / 1000.0 / entry->calls,
+                entry->max_ns / 1000.0, entry->heap_bytes / 1024.0);
+   }
+
+   util_dynarray_fini(&entries);
+
+   simple_mtx_unlock(&passtime_lock);
+}
+
+void
+ir3_passtime_begin(struct ir3_passtime *pt)
+{
+   if (likely(!(ir3_shader_debug & IR3_DBG_PASSTIME))) {
+      pt->start_ns = 0;
+      return;
+   }
+
+   /* Sample the heap first to leave the allocator walk out of the timing */
+   pt->start_heap = heap_size();
+   pt->start_ns = os_time_get_nano();
+}
+
+void
+ir3_passtime_end(struct ir3_passtime *pt, const char *pass)
+{
+   if (likely(!pt->start_ns))
+      return;
+
+   int64_t ns = os_time_get_nano() - pt->start_ns;
+   int64_t heap_bytes = heap_size() - pt->start_heap;
+
+   simple_mtx_lock(&passtime_lock);
+
+   if (!passtime_table) {
+      passtime_table = _mesa_hash_table_create(NULL, _mesa_hash_string,
+                                               _mesa_key_string_equal);
+      atexit(ir3_passtime_dump);
+   }
+
+   struct hash_entry *he = _mesa_hash_table_search(passtime_table, pass);
+   struct ir3_passtime_entry *entry;
+   if (he) {
+      entry = he->data;
+   } else {
+      entry = rzalloc(passtime_table, struct ir3_passtime_entry);
+      entry->pass = pass;
+      _mesa_hash_table_insert(passtime_table, pass, entry);
+   }
+
+   entry->calls++;
+   entry->total_ns += ns;
+   entry->max_ns = MAX2(entry->max_ns, ns);
+   entry->heap_bytes += heap_bytes;
+
+   simple_mtx_unlock(&passtime_lock);
+}
@@ -11,6 +11,10 @@
 #include "tu_image.h"
 #include "tu_pass.h"
 
+#include "util/blob.h"
+#include "util/u_debug.h"
+#include "util/u_process.h"
+
 /* How does it work?
  *
  * - For each renderpass we calculate the number of samples passed
@@ -54,6 +58,17 @@ tu_autotune_free_results_locked(struct tu_device *dev, struct list_head *results
 #define MAX_HISTORY_RESULTS 5
 /* For how many submissions we store renderpass stats. */
 #define MAX_HISTORY_LIFETIME 128
+/* How often, in submissions, the history is written to the disk cache. */
+#define PERSIST_INTERVAL 4096
+/* Upper bound on history entries kept around for the disk cache. */
+#define MAX_PERSISTED_HISTORY 1024
+#define PERSIST_VERSION 2
+/* Every how many decisions the more expensive path is measured again. */
+#define COST_MODEL_PROBE_INTERVAL 64
+/* Weight of a new GPU time measurement in the moving average, as a shift. */
+#define COST_MODEL_EMA_SHIFT 3
+/* CP_ALWAYS_ON_COUNTER is fixed 19.2 MHz */
+#define ALWAYS_ON_TICKS_PER_US 19.2
 
 
 /**
@@ -72,6 +87,18 @@ struct tu_renderpass_history {
    uint32_t num_results;
 
    uint32_t avg_samples;
+
+   /* avg_samples comes from a previous run or from results which have been
+    * freed, and is still usable even though there are no results.
+    */
+   bool persisted;
+
+   /* Moving averages of the GPU time of each path, in CP_ALWAYS_ON_COUNTER
+    * ticks, 0 if not measured yet.
+    */
+   uint32_t sysmem_ticks;
+   uint32_t gmem_ticks;
+   uint32_t decision_count;
 };
 
 /* Holds per-submission cs which writes the fence. */
@@ -213,7 +240,7 @@ get_history(struct tu_autotune *at, uint64_t rp_key, uint32_t *avg_samples)
    if (entry) {
       struct tu_renderpass_history *history =
          (struct tu_renderpass_history *) entry->data;
-      if (history->num_results > 0) {
+      if (history->num_results > 0 || history->persisted) {
          *avg_samples = p_atomic_read(&history->avg_samples);
          has_history = true;
       }
@@ -223,6 +250,42 @@ get_history(struct tu_autotune *at, uint64_t rp_key, uint32_t *avg_samples)
    return has_history;
 }
 
+/* Decide based on the measured GPU time of both paths, measuring a path first
+ * if we don't know its cost.
+ */
+static bool
+get_history_cost(struct tu_autotune *at, uint64_t rp_key, bool *select_sysmem,
+                 uint32_t *saved_ticks)
+{
+   bool has_history = false;
+
+   u_rwlock_rdlock(&at->ht_lock);
+   struct hash_entry *entry = _mesa_hash_table_search(at->ht, &rp_key);
+   if (entry) {
+      struct tu_renderpass_history *history =
+         (struct tu_renderpass_history *) entry->data;
+      uint32_t sysmem_ticks = p_atomic_read(&history->sysmem_ticks);
+      uint32_t gmem_ticks = p_atomic_read(&history->gmem_ticks);
+
+      if (!sysmem_ticks || !gmem_ticks) {
+         *select_sysmem = !sysmem_ticks;
+         *saved_ticks = 0;
+      } else {
+         const bool sysmem_cheaper = sysmem_ticks <= gmem_ticks;
+         const bool probe = p_atomic_inc_return(&history->decision_count) %
+                            COST_MODEL_PROBE_INTERVAL == 0;
+
+         *select_sysmem = sysmem_cheaper != probe;
+         *saved_ticks = probe ? 0 : MAX2(sysmem_ticks, gmem_ticks) -
+                                    MIN2(sysmem_ticks, gmem_ticks);
+      }
+      has_history = true;
+   }
+   u_rwlock_rdunlock(&at->ht_lock);
+
+   return has_history;
+}
+
 static struct tu_renderpass_result *
 create_history_result(struct tu_autotune *at, uint64_t rp_key)
 {
@@ -264,6 +327,24 @@ history_add_result(struct tu_device *dev, struct tu_renderpass_history *history,
    p_atomic_set(&history->avg_samples, (uint32_t)avg_samples);
 }
 
+static void
+history_add_time(struct tu_renderpass_history *history, bool sysmem,
+                 uint64_t elapsed)
+{
+   uint32_t *ema = sysmem ? &history->sysmem_ticks : &history->gmem_ticks;
+   uint32_t ticks = MIN2(elapsed, UINT32_MAX >> 1);
+   uint32_t old_ticks = *ema;
+   uint32_t new_ticks = ticks;
+
+   if (old_ticks) {
+      new_ticks = old_ticks - (old_ticks >> COST_MODEL_EMA_SHIFT) +
+                  (ticks >> COST_MODEL_EMA_SHIFT);
+   }
+
+   /* 0 means the path wasn't measured */
+   p_atomic_set(ema, MAX2(new_ticks, 1));
+}
+
 static void
 process_results(struct tu_autotune *at, uint32_t current_fence)
 {
@@ -278,7 +359,13 @@ process_results(struct tu_autotune *at, uint32_t current_fence)
       result->samples_passed =
          result->samples->samples_end - result->samples->samples_start;
 
+      if (result->has_time) {
+         history_add_time(history, result->sysmem,
+                          result->samples->ts_end - result->samples->ts_start);
+      }
+
       history_add_result(dev, history, result);
+      at->persist_dirty = true;
    }
 
    list_for_each_entry_safe(struct tu_submission_data, submission_data,
@@ -314,6 +401,107 @@ queue_pending_results(struct tu_autotune *at, struct tu_cmd_buffer *cmdbuf)
    }
 }
 
+static void
+init_persist(struct tu_autotune *at)
+{
+   struct disk_cache *cache = at->device->physical_device->vk.disk_cache;
+   const struct vk_app_info *app_info = &at->device->instance->vk.app_info;
+
+   if (!cache || debug_get_bool_option("TU_AUTOTUNE_NO_PERSIST", false))
+      return;
+
+   /* Renderpass keys are only meaningful within an application. The driver
+    * build and GPU are already part of the disk cache's identity.
+    */
+   struct blob blob;
+   blob_init(&blob);
+   blob_write_string(&blob, "tu_autotune");
+   blob_write_uint32(&blob, PERSIST_VERSION);
+   blob_write_string(&blob, util_get_process_name());
+   blob_write_string(&blob, app_info->app_name ?: "");
+   blob_write_uint32(&blob, app_info->app_version);
+   blob_write_string(&blob, app_info->engine_name ?: "");
+   blob_write_uint32(&blob, app_info->engine_version);
+   if (!blob.out_of_memory) {
+      disk_cache_compute_key(cache, blob.data, blob.size, at->persist_key);
+      at->persist = true;
+   }
+   blob_finish(&blob);
+}
+
+static void
+load_history(struct tu_autotune *at)
+{
+   struct disk_cache *cache = at->device->physical_device->vk.disk_cache;
+   size_t size;
+   void *data = disk_cache_get(cache, at->persist_key, &size);
+   if (!data)
+      return;
+
+   struct blob_reader blob;
+   blob_reader_init(&blob, data, size);
+
+   uint32_t count = blob_read_uint32(&blob);
+   for (uint32_t i = 0; i < MIN2(count, MAX_PERSISTED_HISTORY); i++) {
+      uint64_t key = blob_read_uint64(&blob);
+      uint32_t avg_samples = blob_read_uint32(&blob);
+      uint32_t sysmem_ticks = blob_read_uint32(&blob);
+      uint32_t gmem_ticks = blob_read_uint32(&blob);
+      if (blob.overrun)
+         break;
+
+      if (_mesa_hash_table_search(at->ht, &key))
+         continue;
+
+      struct tu_renderpass_history *history =
+         (struct tu_renderpass_history *) calloc(1, sizeof(*history));
+      history->key = key;
+      history->avg_samples = avg_samples;
+      history->sysmem_ticks = sysmem_ticks;
+      history->gmem_ticks = gmem_ticks;
+      history->persisted = true;
+      list_inithead(&history->results);
+      _mesa_hash_table_insert(at->ht, &history->key, history);
+   }
+
+   if (TU_AUTOTUNE_DEBUG_LOG)
+      mesa_logi("Loaded %u history entries", at->ht->entries);
+
+   free(data);
+}
+
+static void
+store_history(struct tu_autotune *at)
+{
+   struct disk_cache *cache = at->device->physical_device->vk.disk_cache;
+   struct blob blob;
+   blob_init(&blob);
+
+   intptr_t count_offset = blob_reserve_uint32(&blob);
+   uint32_t count = 0;
+   hash_table_foreach(at->ht, entry) {
+      struct tu_renderpass_history *history =
+         (struct tu_renderpass_history *) entry->data;
+      if (history->num_results == 0 && !history->persisted)
+         continue;
+
+      blob_write_uint64(&blob, history->key);
+      blob_write_uint32(&blob, history->avg_samples);
+      blob_write_uint32(&blob, history->sysmem_ticks);
+      blob_write_uint32(&blob, history->gmem_ticks);
+      if (++count == MAX_PERSISTED_HISTORY)
+         break;
+   }
+   blob_overwrite_uint32(&blob, count_offset, count);
+
+   if (!blob.out_of_memory)
+      disk_cache_put(cache, at->persist_key, blob.data, blob.size, NULL);
+   blob_finish(&blob);
+
+   at->persist_dirty = false;
+   at->persist_fence = at->fence_counter;
+}
+
 struct tu_cs *
 tu_autotune_on_submit(struct tu_device *dev,
                       struct tu_autotune *at,
@@ -381,6 +569,21 @@ tu_autotune_on_submit(struct tu_device *dev,
       if (fence_before(gpu_fence, history->last_fence + MAX_HISTORY_LIFETIME))
          continue;
 
+      /* Keep the averages of stale entries around for the disk cache, just
+       * drop the results.
+       */
+      if (at->persist && at->ht->entries <= MAX_PERSISTED_HISTORY) {
+         if (history->num_results > 0) {
+            mtx_lock(&dev->autotune_mutex);
+            tu_autotune_free_results_locked(dev, &history->results);
+            mtx_unlock(&dev->autotune_mutex);
+            history->num_results = 0;
+            history->persisted = true;
+         }
+         if (history->persisted)
+            continue;
+      }
+
       if (TU_AUTOTUNE_DEBUG_LOG)
          mesa_logi("Removed old history entry %016" PRIx64 "", history->key);
 
@@ -393,6 +596,21 @@ tu_autotune_on_submit(struct tu_device *dev,
       mtx_unlock(&dev->autotune_mutex);
    }
 
+   if (at->cost_model) {
+      MESA_TRACE_SET_COUNTER("tu_autotune_sysmem_passes",
+                             p_atomic_xchg(&at->cost_model_sysmem_passes, 0));
+      MESA_TRACE_SET_COUNTER("tu_autotune_gmem_passes",
+                             p_atomic_xchg(&at->cost_model_gmem_passes, 0));
+      MESA_TRACE_SET_COUNTER("tu_autotune_saved_us",
+                             p_atomic_xchg(&at->cost_model_saved_ticks, 0) /
+                             ALWAYS_ON_TICKS_PER_US);
+   }
+
+   if (at->persist && at->persist_dirty &&
+       !fence_before(new_fence, at->persist_fence + PERSIST_INTERVAL)) {
+      store_history(at);
+   }
+
    return &submission_data->fence_cs;
 }
 
@@ -425,6 +643,14 @@ tu_autotune_init(struct tu_autotune *at, struct tu_device *dev)
    /* start from 1 because tu6_global::autotune_fence is initialized to 0 */
    at->fence_counter = 1;
 
+   at->cost_model = debug_get_bool_option("TU_AUTOTUNE_COST_MODEL", false);
+
+   init_persist(at);
+   if (at->persist) {
+      load_history(at);
+      at->persist_fence = at->fence_counter;
+   }
+
    return VK_SUCCESS;
 }
 
@@ -446,6 +672,9 @@ tu_autotune_fini(struct tu_autotune *at, struct tu_device *dev)
       }
    }
 
+   if (at->persist && at->persist_dirty)
+      store_history(at);
+
    tu_autotune_free_results(dev, &at->pending_results);
 
    mtx_lock(&dev->autotune_mutex);
@@ -589,6 +818,23 @@ tu_autotune_use_bypass(struct tu_autotune *at,
 
    *autotune_result = create_history_result(at, renderpass_key);
 
+   bool select_sysmem;
+   uint32_t saved_ticks;
+   if (at->cost_model &&
+       get_history_cost(at, renderpass_key, &select_sysmem, &saved_ticks)) {
+      p_atomic_inc(select_sysmem ? &at->cost_model_sysmem_passes
+                                 : &at->cost_model_gmem_passes);
+      p_atomic_add(&at->cost_model_saved_ticks, (uint64_t) saved_ticks);
+
+      if (TU_AUTOTUNE_DEBUG_LOG) {
+         mesa_logi("autotune %016" PRIx64 " selecting %s, saving %u ticks",
+                   renderpass_key, select_sysmem ? "sysmem" : "gmem",
+                   saved_ticks);
+      }
+
+      return select_sysmem;
+   }
+
    uint32_t avg_samples = 0;
    if (get_history(at, renderpass_key, &avg_samples)) {
       const uint32_t pass_pixel_count =
@@ -639,6 +885,89 @@ tu_autotune_use_bypass(struct tu_autotune *at,
    return fallback_use_bypass(pass, framebuffer, cmd_buffer);
 }
 
+static bool
+alloc_result_bo(struct tu_device *dev, struct tu_renderpass_result *autotune_result)
+{
+   if (autotune_result->bo.bo)
+      return true;
+
+   static const uint32_t size = sizeof(struct tu_renderpass_samples);
+
+   mtx_lock(&dev->autotune_mutex);
+   VkResult ret = tu_suballoc_bo_alloc(&autotune_result->bo, &dev->autotune_suballoc, size, 16);
+   mtx_unlock(&dev->autotune_mutex);
+   if (ret != VK_SUCCESS) {
+      autotune_result->bo.bo = NULL;
+      autotune_result->bo.iova = 0;
+      return false;
+   }
+
+   autotune_result->samples =
+      (struct tu_renderpass_samples *) tu_suballoc_bo_map(
+         &autotune_result->bo);
+
+   return true;
+}
+
+template <chip CHIP>
+static void
+emit_timestamp(struct tu_cs *cs, uint64_t iova)
+{
+   if (CHIP == A6XX) {
+      tu_cs_emit_pkt7(cs, CP_EVENT_WRITE, 4);
+      tu_cs_emit(cs, CP_EVENT_WRITE_0_EVENT(RB_DONE_TS) |
+                     CP_EVENT_WRITE_0_TIMESTAMP);
+      tu_cs_emit_qw(cs, iova);
+      tu_cs_emit(cs, 0x00000000);
+   } else {
+      tu_cs_emit_pkt7(cs, CP_EVENT_WRITE7, 3);
+      tu_cs_emit(cs, CP_EVENT_WRITE7_0(.event = RB_DONE_TS,
+                                       .write_src = EV_WRITE_ALWAYSON,
+                                       .write_dst = EV_DST_RAM,
+                                       .write_enabled = true).value);
+      tu_cs_emit_qw(cs, iova);
+   }
+}
+
+/* Unlike the samples, the GPU time has to cover everything the path does,
+ * including the binning pass and the sysmem resolves, so this brackets the
+ * whole renderpass.
+ */
+template <chip CHIP>
+void
+tu_autotune_begin_renderpass_time(struct tu_cmd_buffer *cmd,
+                                  struct tu_cs *cs,
+                                  struct tu_renderpass_result *autotune_result,
+                                  bool sysmem)
+{
+   if (!autotune_result || !cmd->device->autotune.cost_model)
+      return;
+
+   if (!alloc_result_bo(cmd->device, autotune_result))
+      return;
+
+   autotune_result->sysmem = sysmem;
+   autotune_result->has_time = true;
+
+   emit_timestamp<CHIP>(cs, autotune_result->bo.iova +
+                               offsetof(struct tu_renderpass_samples, ts_start));
+}
+TU_GENX(tu_autotune_begin_renderpass_time);
+
+template <chip CHIP>
+void
+tu_autotune_end_renderpass_time(struct tu_cmd_buffer *cmd,
+                                struct tu_cs *cs,
+                                struct tu_renderpass_result *autotune_result)
+{
+   if (!autotune_result || !autotune_result->has_time)
+      return;
+
+   emit_timestamp<CHIP>(cs, autotune_result->bo.iova +
+                               offsetof(struct tu_renderpass_samples, ts_end));
+}
+TU_GENX(tu_autotune_end_renderpass_time);
+
 template <chip CHIP>
 void
 tu_autotune_begin_renderpass(struct tu_cmd_buffer *cmd,
@@ -650,22 +979,11 @@ tu_autotune_begin_renderpass(struct tu_cmd_buffer *cmd,
 
    struct tu_device *dev = cmd->device;
 
-   static const uint32_t size = sizeof(struct tu_renderpass_samples);
-
-   mtx_lock(&dev->autotune_mutex);
-   VkResult ret = tu_suballoc_bo_alloc(&autotune_result->bo, &dev->autotune_suballoc, size, size);
-   mtx_unlock(&dev->autotune_mutex);
-   if (ret != VK_SUCCESS) {
-      autotune_result->bo.iova = 0;
+   if (!alloc_result_bo(dev, autotune_result))
       return;
-   }
 
    uint64_t result_iova = autotune_result->bo.iova;
 
-   autotune_result->samples =
-      (struct tu_renderpass_samples *) tu_suballoc_bo_map(
-         &autotune_result->bo);
-
    tu_cs_emit_regs(cs, A6XX_RB_SAMPLE_COUNT_CONTROL(.copy = true));
    if (cmd->device->physical_device->info->a7xx.has_event_write_sample_count) {
       tu_cs_emit_pkt7(cs, CP_EVENT_WRITE7, 3);
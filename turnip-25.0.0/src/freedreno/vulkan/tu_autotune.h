@@ -8,6 +8,7 @@
 
 #include "tu_common.h"
 
+#include "util/disk_cache.h"
 #include "util/hash_table.h"
 #include "util/rwlock.h"
 
@@ -41,6 +42,11 @@ struct tu_renderpass_history;
  * the amount of overdraw to detect cases where the number of pixels touched is
  * low.
  *
+ * Optionally (TU_AUTOTUNE_COST_MODEL=1) the GPU time of each renderpass is
+ * measured as well, and once both paths have been measured for a given
+ * renderpass the cheaper one is taken, with the other path being probed
+ * every now and then to track changes in the workload.
+ *
  * [1] ignoring early-tile-exit optimizations, but any draw that touches all/
  *     most of the tiles late in the tile-pass can defeat that
  */
@@ -81,6 +87,25 @@ struct tu_autotune {
 
    uint32_t fence_counter;
    uint32_t idx_counter;
+
+   /**
+    * Whether the history is saved to and restored from the disk cache, so
+    * that decisions don't have to be relearned on every launch.
+    */
+   bool persist;
+   bool persist_dirty;
+   uint32_t persist_fence;
+   cache_key persist_key;
+
+   /* Whether decisions are based on the measured GPU time of each path. */
+   bool cost_model;
+
+   /* Decisions and estimated savings since the last submission, reported
+    * as perfetto counters.
+    */
+   uint32_t cost_model_sysmem_passes;
+   uint32_t cost_model_gmem_passes;
+   uint64_t cost_model_saved_ticks;
 };
 
 /**
@@ -96,6 +121,10 @@ struct PACKED tu_renderpass_samples {
    uint64_t __pad0;
    uint64_t samples_end;
    uint64_t __pad1;
+
+   /* CP_ALWAYS_ON_COUNTER values, only written with the cost model. */
+   uint64_t ts_start;
+   uint64_t ts_end;
 };
 
 /* Necessary when writing sample counts using CP_EVENT_WRITE7::ZPASS_DONE. */
@@ -120,6 +149,10 @@ struct tu_renderpass_result {
    struct list_head node;
    uint32_t fence;
    uint64_t samples_passed;
+
+   /* Which path was taken, and whether its GPU time was recorded. */
+   bool sysmem;
+   bool has_time;
 };
 
 VkResult tu_autotune_init(struct tu_autotune *at, struct tu_device *dev);
@@ -154,4 +187,15 @@ void tu_autotune_end_renderpass(struct tu_cmd_buffer *cmd,
                                 struct tu_cs *cs,
                                 struct tu_renderpass_result *autotune_result);
 
+template <chip CHIP>
+void tu_autotune_begin_renderpass_time(struct tu_cmd_buffer *cmd,
+                                       struct tu_cs *cs,
+                                       struct tu_renderpass_result *autotune_result,
+                                       bool sysmem);
+
+template <chip CHIP>
+void tu_autotune_end_renderpass_time(struct tu_cmd_buffer *cmd,
+                                     struct tu_cs *cs,
+                                     struct tu_renderpass_result *autotune_result);
+
 #endif /* TU_AUTOTUNE_H */
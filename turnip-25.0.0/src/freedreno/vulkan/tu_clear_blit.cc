@@ -15,6 +15,7 @@
 #include "util/format_srgb.h"
 #include "util/half_float.h"
 #include "compiler/nir/nir_builder.h"
+#include "vk_pipeline.h"
 
 #include "tu_buffer.h"
 #include "tu_cmd_buffer.h"
@@ -376,6 +377,8 @@ r2d_src_buffer_unaligned(struct tu_cmd_buffer *cmd,
 
    uint32_t offset_texels = ((va & 0x3f) / util_format_get_blocksize(format));
    va &= ~0x3f;
+   /* r2d_setup() expects the default TPL1_2D_SRC_CNTL */
+   cmd->state.r2d_state.valid = false;
    tu_cs_emit_regs(cs,
                    A7XX_TPL1_2D_SRC_CNTL(.raw_copy = false,
                                          .start_offset_texels = offset_texels,
@@ -467,6 +470,13 @@ r2d_setup_common(struct tu_cmd_buffer *cmd,
       tu_cs_emit_call(cs, cmd->device->dbg_renderpass_stomp_cs);
    }
 
+   /* Only track the state emitted unconditionally to the primary CS between
+    * render passes, where it is executed in recording order.
+    */
+   bool cacheable = cs == &cmd->cs && !cmd->state.pass &&
+                    !cs->cond_stack_depth &&
+                    !cmd->device->dbg_renderpass_stomp_cs;
+
    enum a6xx_format fmt = blit_base_format<CHIP>(dst_format, ubwc, false);
    fixup_dst_format(src_format, &dst_format, &fmt);
    enum a6xx_2d_ifmt ifmt = format_to_ifmt(dst_format);
@@ -483,9 +493,6 @@ r2d_setup_common(struct tu_cmd_buffer *cmd,
          unknown_8c01 = 0x00084001;
    }
 
-   tu_cs_emit_pkt4(cs, REG_A6XX_RB_2D_UNKNOWN_8C01, 1);
-   tu_cs_emit(cs, unknown_8c01);    // TODO: seem to be always 0 on A7XX
-
    uint32_t blit_cntl = A6XX_RB_2D_BLIT_CNTL(
          .rotate = (enum a6xx_rotation) blit_param,
          .solid_color = clear,
@@ -496,6 +503,25 @@ r2d_setup_common(struct tu_cmd_buffer *cmd,
          .ifmt = util_format_is_srgb(dst_format) ? R2D_UNORM8_SRGB : ifmt,
       ).value;
 
+   if (fmt == FMT6_10_10_10_2_UNORM_DEST)
+      fmt = FMT6_16_16_16_16_FLOAT;
+
+   const struct fd_reg_pair dst_format_reg = SP_2D_DST_FORMAT(CHIP,
+         .sint = util_format_is_pure_sint(dst_format),
+         .uint = util_format_is_pure_uint(dst_format),
+         .color_format = fmt,
+         .srgb = util_format_is_srgb(dst_format),
+         .mask = 0xf);
+
+   if (cacheable && cmd->state.r2d_state.valid &&
+       cmd->state.r2d_state.unknown_8c01 == unknown_8c01 &&
+       cmd->state.r2d_state.blit_cntl == blit_cntl &&
+       cmd->state.r2d_state.dst_format == dst_format_reg.value)
+      return;
+
+   tu_cs_emit_pkt4(cs, REG_A6XX_RB_2D_UNKNOWN_8C01, 1);
+   tu_cs_emit(cs, unknown_8c01);    // TODO: seem to be always 0 on A7XX
+
    tu_cs_emit_pkt4(cs, REG_A6XX_RB_2D_BLIT_CNTL, 1);
    tu_cs_emit(cs, blit_cntl);
 
@@ -508,15 +534,12 @@ r2d_setup_common(struct tu_cmd_buffer *cmd,
                                                 .type = A6XX_TEX_2D));
    }
 
-   if (fmt == FMT6_10_10_10_2_UNORM_DEST)
-      fmt = FMT6_16_16_16_16_FLOAT;
+   tu_cs_emit_regs(cs, dst_format_reg);
 
-   tu_cs_emit_regs(cs, SP_2D_DST_FORMAT(CHIP,
-         .sint = util_format_is_pure_sint(dst_format),
-         .uint = util_format_is_pure_uint(dst_format),
-         .color_format = fmt,
-         .srgb = util_format_is_srgb(dst_format),
-         .mask = 0xf));
+   cmd->state.r2d_state.valid = cacheable;
+   cmd->state.r2d_state.unknown_8c01 = unknown_8c01;
+   cmd->state.r2d_state.blit_cntl = blit_cntl;
+   cmd->state.r2d_state.dst_format = dst_format_reg.value;
 }
 
 template <chip CHIP>
@@ -790,6 +813,76 @@ build_clear_fs_shader(unsigned mrts)
    return b->shader;
 }
 
+/* A copy of dwords from src_va, or a fill with data if src_va is 0. */
+struct tu_buffer_job {
+   uint64_t dst_va;
+   uint64_t src_va;
+   uint32_t dwords;
+   uint32_t data;
+};
+
+#define TU_BUFFER_JOB_MAX_SIZE 4096
+#define TU_BUFFER_JOB_MAX_COUNT 256
+#define TU_BUFFER_JOB_WG_SIZE 64
+
+/* Executes one struct tu_buffer_job per workgroup, each invocation copying or
+ * filling every TU_BUFFER_JOB_WG_SIZE-th dword of it.
+ */
+static nir_shader *
+build_buffer_jobs_cs_shader(void)
+{
+   nir_builder _b =
+      nir_builder_init_simple_shader(MESA_SHADER_COMPUTE, NULL,
+                                     "buffer jobs cs");
+   nir_builder *b = &_b;
+   b->shader->info.internal = true;
+   b->shader->info.workgroup_size[0] = TU_BUFFER_JOB_WG_SIZE;
+   b->shader->info.workgroup_size[1] = 1;
+   b->shader->info.workgroup_size[2] = 1;
+
+   nir_def *jobs = nir_load_push_constant(b, 1, 64, nir_imm_int(b, 0),
+                                          .base = 0,
+                                          .range = sizeof(uint64_t));
+   nir_def *job_id = nir_channel(b, nir_load_workgroup_id(b), 0);
+   nir_def *job =
+      nir_iadd(b, jobs, nir_u2u64(b, nir_imul_imm(b, job_id,
+                                                  sizeof(struct tu_buffer_job))));
+
+   static_assert(offsetof(struct tu_buffer_job, dst_va) == 0);
+   static_assert(offsetof(struct tu_buffer_job, src_va) == 8);
+   static_assert(offsetof(struct tu_buffer_job, dwords) == 16);
+   static_assert(offsetof(struct tu_buffer_job, data) == 20);
+   nir_def *addrs = nir_load_global(b, job, 8, 4, 32);
+   nir_def *params = nir_load_global(b, nir_iadd_imm(b, job, 16), 8, 2, 32);
+   nir_def *dst = nir_pack_64_2x32(b, nir_channels(b, addrs, 0x3));
+   nir_def *src = nir_pack_64_2x32(b, nir_channels(b, addrs, 0xc));
+   nir_def *dwords = nir_channel(b, params, 0);
+   nir_def *data = nir_channel(b, params, 1);
+
+   nir_variable *idx =
+      nir_local_variable_create(b->impl, glsl_uint_type(), "idx");
+   nir_store_var(b, idx, nir_load_local_invocation_index(b), 0x1);
+
+   nir_push_loop(b);
+   {
+      nir_def *i = nir_load_var(b, idx);
+      nir_break_if(b, nir_uge(b, i, dwords));
+
+      nir_def *offset = nir_u2u64(b, nir_ishl_imm(b, i, 2));
+
+      nir_push_if(b, nir_ine_imm(b, src, 0));
+      nir_def *loaded = nir_load_global(b, nir_iadd(b, src, offset), 4, 1, 32);
+      nir_pop_if(b, NULL);
+      nir_def *value = nir_if_phi(b, loaded, data);
+
+      nir_store_global(b, nir_iadd(b, dst, offset), 4, value, 0x1);
+      nir_store_var(b, idx, nir_iadd_imm(b, i, TU_BUFFER_JOB_WG_SIZE), 0x1);
+   }
+   nir_pop_loop(b, NULL);
+
+   return b->shader;
+}
+
 static void
 compile_shader(struct tu_device *dev, struct nir_shader *nir,
                unsigned consts, unsigned *offset, enum global_shader idx)
@@ -2515,6 +2608,182 @@ tu_CmdCopyBufferToImage2(VkCommandBuffer commandBuffer,
 }
 TU_GENX(tu_CmdCopyBufferToImage2);
 
+/* Host image copies of more than this many bytes are split up and executed on
+ * the device worker queue, smaller ones are done inline.
+ */
+#define TU_HOST_COPY_THREADED_MIN_SIZE (4 * 1024 * 1024)
+/* Don't split copies into jobs smaller than this. */
+#define TU_HOST_COPY_JOB_MIN_SIZE (512 * 1024)
+#define TU_HOST_COPY_MAX_JOBS 32
+/* Row bands are aligned to this many rows, which is a multiple of the 2K
+ * macrotile height for every cpp, so that jobs never share a macrotile.
+ */
+#define TU_HOST_COPY_BAND_ALIGN 32
+
+/* A copy of a rectangle in a range of layers between host memory and a
+ * mapped image, as done by VK_EXT_host_image_copy.
+ */
+struct tu_host_copy {
+   const struct fdl_layout *layout;
+   const struct fdl_ubwc_config *ubwc_config;
+   unsigned miplevel;
+   bool to_image;
+   bool copy_memcpy;
+   bool tiled;
+
+   /* Pointers to the first layer */
+   char *image;
+   char *mem;
+
+   uint32_t image_layer_stride;
+   uint32_t mem_layer_stride;
+   uint32_t mem_pitch;
+
+   VkOffset2D offset;
+   VkExtent2D extent;
+};
+
+struct tu_host_copy_job {
+   const struct tu_host_copy *copy;
+   uint32_t first_layer, layer_count;
+   /* Rows to copy, in image coordinates */
+   uint32_t y, height;
+   struct util_queue_fence fence;
+};
+
+static void
+tu_host_copy_job_run(const struct tu_host_copy_job *job)
+{
+   const struct tu_host_copy *copy = job->copy;
+   const struct fdl_layout *layout = copy->layout;
+   uint32_t cpp = layout->cpp;
+
+   for (uint32_t layer = job->first_layer;
+        layer < job->first_layer + job->layer_count; layer++) {
+      char *image = copy->image + layer * copy->image_layer_stride;
+      char *mem = copy->mem + layer * copy->mem_layer_stride +
+                  (job->y - copy->offset.y) * copy->mem_pitch;
+
+      if (copy->copy_memcpy) {
+         /* The whole layer is copied, these are never split into bands. */
+         assert(job->y == copy->offset.y &&
+                job->height == copy->extent.height);
+         if (copy->to_image)
+            memcpy(image, mem, copy->mem_layer_stride);
+         else
+            memcpy(mem, image, copy->mem_layer_stride);
+      } else if (!copy->tiled) {
+         uint32_t image_pitch = fdl_pitch(layout, copy->miplevel);
+         for (uint32_t y = 0; y < job->height; y++) {
+            char *image_row = image + image_pitch * (job->y + y) +
+                              copy->offset.x * cpp;
+            char *mem_row = mem + copy->mem_pitch * y;
+            if (copy->to_image)
+               memcpy(image_row, mem_row, copy->extent.width * cpp);
+            else
+               memcpy(mem_row, image_row, copy->extent.width * cpp);
+         }
+      } else if (copy->to_image) {
+         fdl6_memcpy_linear_to_tiled(copy->offset.x, job->y,
+                                     copy->extent.width, job->height,
+                                     image, mem, layout, copy->miplevel,
+                                     copy->mem_pitch, copy->ubwc_config);
+      } else {
+         fdl6_memcpy_tiled_to_linear(copy->offset.x, job->y,
+                                     copy->extent.width, job->height,
+                                     mem, image, layout, copy->miplevel,
+                                     copy->mem_pitch, copy->ubwc_config);
+      }
+   }
+}
+
+static void
+tu_host_copy_job_execute(void *job, void *gdata, int thread_index)
+{
+   tu_host_copy_job_run((const struct tu_host_copy_job *) job);
+}
+
+/* Execute a host copy, splitting it into layers and macrotile-aligned row
+ * bands spread across the worker queue if it's large enough to be worth it.
+ */
+static void
+tu_host_copy_execute(struct tu_device *device,
+                     const struct tu_host_copy *copy,
+                     uint32_t layers)
+{
+   struct tu_host_copy_job jobs[TU_HOST_COPY_MAX_JOBS];
+   uint64_t size = copy->copy_memcpy ?
+      (uint64_t) copy->mem_layer_stride * layers :
+      (uint64_t) copy->extent.width * copy->extent.height *
+                 copy->layout->cpp * layers;
+
+   if (!util_queue_is_initialized(&device->worker_queue) ||
+       size < TU_HOST_COPY_THREADED_MIN_SIZE) {
+      jobs[0] = (struct tu_host_copy_job) {
+         .copy = copy,
+         .first_layer = 0,
+         .layer_count = layers,
+         .y = (uint32_t) copy->offset.y,
+         .height = copy->extent.height,
+      };
+      tu_host_copy_job_run(&jobs[0]);
+      return;
+   }
+
+   /* Over-split a bit to even out imbalances between threads. */
+   unsigned num_threads = device->worker_queue.max_threads + 1;
+   unsigned max_jobs = MIN3(TU_HOST_COPY_MAX_JOBS, 2 * num_threads,
+                            size / TU_HOST_COPY_JOB_MIN_SIZE);
+
+   /* Prefer splitting by layer, and only split layers into bands when there
+    * aren't enough of them to go around.
+    */
+   uint32_t y_start = copy->offset.y;
+   uint32_t y_end = y_start + copy->extent.height;
+   uint32_t bands = 1;
+   if (!copy->copy_memcpy && layers < max_jobs) {
+      uint32_t aligned_height =
+         y_end - ROUND_DOWN_TO(y_start, TU_HOST_COPY_BAND_ALIGN);
+      bands = MIN2(max_jobs / layers,
+                   DIV_ROUND_UP(aligned_height, TU_HOST_COPY_BAND_ALIGN));
+   }
+   uint32_t band_height =
+      align(DIV_ROUND_UP(y_end - ROUND_DOWN_TO(y_start, TU_HOST_COPY_BAND_ALIGN),
+                         bands), TU_HOST_COPY_BAND_ALIGN);
+   uint32_t layers_per_job = bands > 1 ? 1 : DIV_ROUND_UP(layers, max_jobs);
+
+   unsigned num_jobs = 0;
+   for (uint32_t layer = 0; layer < layers; layer += layers_per_job) {
+      for (uint32_t y = y_start; y < y_end;) {
+         uint32_t band_end =
+            MIN2(ROUND_DOWN_TO(y, TU_HOST_COPY_BAND_ALIGN) + band_height, y_end);
+         assert(num_jobs < ARRAY_SIZE(jobs));
+         jobs[num_jobs++] = (struct tu_host_copy_job) {
+            .copy = copy,
+            .first_layer = layer,
+            .layer_count = MIN2(layers_per_job, layers - layer),
+            .y = y,
+            .height = band_end - y,
+         };
+         y = band_end;
+      }
+   }
+
+   /* Hand off everything but the first job, which we do ourselves. */
+   for (unsigned i = 1; i < num_jobs; i++) {
+      util_queue_fence_init(&jobs[i].fence);
+      util_queue_add_job(&device->worker_queue, &jobs[i], &jobs[i].fence,
+                         tu_host_copy_job_execute, NULL, 0);
+   }
+
+   tu_host_copy_job_run(&jobs[0]);
+
+   for (unsigned i = 1; i < num_jobs; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+}
+
 static void
 tu_copy_memory_to_image(struct tu_device *device,
                         struct tu_image *dst_image,
@@ -2552,37 +2821,30 @@ tu_copy_memory_to_image(struct tu_device *device,
    uint32_t src_layer_stride =
       copy_memcpy ? dst_layer_size :
       (src_width * src_height * layout->cpp);
-   bool tiled =
-      fdl_tile_mode(layout, info->imageSubresource.mipLevel) != 0;
 
-   const char *src = (const char *) info->pHostPointer;
-   char *dst = (char *) dst_image->map + image_offset;
-   for (unsigned layer = 0; layer < layers; layer++,
-        src += src_layer_stride, dst += dst_layer_stride) {
-      if (copy_memcpy) {
-         memcpy(dst, src, src_layer_stride);
-      } else if (!tiled) {
-         uint32_t dst_pitch = fdl_pitch(layout,
-                                        info->imageSubresource.mipLevel);
-         for (unsigned y = 0; y < extent.height; y++) {
-            memcpy(dst + dst_pitch * (y + offset.y) + offset.x * layout->cpp,
-                   src + src_pitch * y,
-                   extent.width * layout->cpp);
-         }
-      } else {
-         fdl6_memcpy_linear_to_tiled(offset.x, offset.y,
-                                     extent.width, extent.height,
-                                     dst, src, layout,
-                                     info->imageSubresource.mipLevel,
-                                     src_pitch,
-                                     &device->physical_device->ubwc_config);
-      }
+   const struct tu_host_copy copy = {
+      .layout = layout,
+      .ubwc_config = &device->physical_device->ubwc_config,
+      .miplevel = info->imageSubresource.mipLevel,
+      .to_image = true,
+      .copy_memcpy = copy_memcpy,
+      .tiled = fdl_tile_mode(layout, info->imageSubresource.mipLevel) != 0,
+      .image = (char *) dst_image->map + image_offset,
+      .mem = (char *) info->pHostPointer,
+      .image_layer_stride = dst_layer_stride,
+      .mem_layer_stride = src_layer_stride,
+      .mem_pitch = src_pitch,
+      .offset = { offset.x, offset.y },
+      .extent = { extent.width, extent.height },
+   };
 
-      if (dst_image->bo->cached_non_coherent) {
-         tu_bo_sync_cache(device, dst_image->bo,
-                          dst_image->bo_offset + image_offset,
-                          dst_layer_size, TU_MEM_SYNC_CACHE_TO_GPU);
-      }
+   tu_host_copy_execute(device, &copy, layers);
+
+   if (dst_image->bo->cached_non_coherent) {
+      tu_bo_sync_cache(device, dst_image->bo,
+                       dst_image->bo_offset + image_offset,
+                       (layers - 1) * dst_layer_stride + dst_layer_size,
+                       TU_MEM_SYNC_CACHE_TO_GPU);
    }
 }
 
@@ -2735,38 +2997,31 @@ tu_copy_image_to_memory(struct tu_device *device,
       layout->slices[info->imageSubresource.mipLevel].size0;
    uint32_t dst_layer_stride =
       copy_memcpy ? src_layer_size : (dst_width * dst_height * layout->cpp);
-   bool tiled =
-      fdl_tile_mode(layout, info->imageSubresource.mipLevel) != 0;
 
-   const char *src = (const char *) src_image->map + image_offset;
-   char *dst = (char *) info->pHostPointer;
-   for (unsigned layer = 0; layer < layers; layer++,
-        src += src_layer_stride, dst += dst_layer_stride) {
-      if (src_image->bo->cached_non_coherent) {
-         tu_bo_sync_cache(device, src_image->bo,
-                          src_image->bo_offset + image_offset,
-                          src_layer_size, TU_MEM_SYNC_CACHE_FROM_GPU);
-      }
+   if (src_image->bo->cached_non_coherent) {
+      tu_bo_sync_cache(device, src_image->bo,
+                       src_image->bo_offset + image_offset,
+                       (layers - 1) * src_layer_stride + src_layer_size,
+                       TU_MEM_SYNC_CACHE_FROM_GPU);
+   }
+
+   const struct tu_host_copy copy = {
+      .layout = layout,
+      .ubwc_config = &device->physical_device->ubwc_config,
+      .miplevel = info->imageSubresource.mipLevel,
+      .to_image = false,
+      .copy_memcpy = copy_memcpy,
+      .tiled = fdl_tile_mode(layout, info->imageSubresource.mipLevel) != 0,
+      .image = (char *) src_image->map + image_offset,
+      .mem = (char *) info->pHostPointer,
+      .image_layer_stride = src_layer_stride,
+      .mem_layer_stride = dst_layer_stride,
+      .mem_pitch = dst_pitch,
+      .offset = { offset.x, offset.y },
+      .extent = { extent.width, extent.height },
+   };
 
-      if (copy_memcpy) {
-         memcpy(dst, src, dst_layer_stride);
-      } else if (!tiled) {
-         uint32_t src_pitch = fdl_pitch(layout,
-                                        info->imageSubresource.mipLevel);
-         for (unsigned y = 0; y < extent.height; y++) {
-            memcpy(dst + dst_pitch * y,
-                   src + src_pitch * (y + offset.y) + offset.x * layout->cpp,
-                   extent.width * layout->cpp);
-         }
-      } else {
-         fdl6_memcpy_tiled_to_linear(offset.x, offset.y,
-                                     extent.width, extent.height,
-                                     dst, src, layout,
-                                     info->imageSubresource.mipLevel,
-                                     dst_pitch,
-                                     &device->physical_device->ubwc_config);
-      }
-   }
+   tu_host_copy_execute(device, &copy, layers);
 }
 
 VKAPI_ATTR VkResult VKAPI_CALL
@@ -3237,6 +3492,176 @@ tu_TransitionImageLayoutEXT(VkDevice device,
    return VK_SUCCESS;
 }
 
+static VkResult
+get_buffer_jobs_pipeline(struct tu_device *device,
+                         VkPipeline *pipeline, VkPipelineLayout *layout)
+{
+   static const char key[] = "tu-buffer-jobs";
+
+   const VkPushConstantRange pc_range = {
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      .offset = 0,
+      .size = sizeof(uint64_t),
+   };
+
+   VkResult result = vk_meta_get_pipeline_layout(&device->vk, &device->meta,
+                                                 NULL, &pc_range, key,
+                                                 strlen(key), layout);
+   if (result != VK_SUCCESS)
+      return result;
+
+   VkPipeline pipeline_from_cache =
+      vk_meta_lookup_pipeline(&device->meta, key, strlen(key));
+   if (pipeline_from_cache != VK_NULL_HANDLE) {
+      *pipeline = pipeline_from_cache;
+      return VK_SUCCESS;
+   }
+
+   const VkPipelineShaderStageNirCreateInfoMESA nir_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_NIR_CREATE_INFO_MESA,
+      .nir = build_buffer_jobs_cs_shader(),
+   };
+
+   const VkComputePipelineCreateInfo pipeline_info = {
+      .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+      .stage = {
+         .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+         .pNext = &nir_info,
+         .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+         .pName = "main",
+      },
+      .layout = *layout,
+   };
+
+   result = vk_meta_create_compute_pipeline(&device->vk, &device->meta,
+                                            &pipeline_info, key, strlen(key),
+                                            pipeline);
+
+   ralloc_free(nir_info.nir);
+
+   return result;
+}
+
+/* Small buffer copies, fills and updates outside of render passes are
+ * executed as jobs of a compute dispatch instead of 2D blits, which each need
+ * the blitter to be set up and the CCU to be in sysmem mode, and flushed
+ * around stores that aren't aligned to 64 bytes. The dispatch is indirect
+ * with one workgroup per job, so that while nothing else is recorded in
+ * between, more jobs can be appended to the list of the last dispatch by
+ * bumping its workgroup count.
+ */
+static bool
+tu_buffer_jobs_allowed(struct tu_cmd_buffer *cmd, uint64_t dst_va,
+                       uint64_t src_va, uint64_t size)
+{
+   return !TU_DEBUG(BLIT_BUFFERS) && size <= TU_BUFFER_JOB_MAX_SIZE &&
+          !((dst_va | src_va | size) & 3) &&
+          !(cmd->inherited_pipeline_statistics &
+            VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT);
+}
+
+template <chip CHIP>
+static void
+tu_buffer_jobs_add(struct tu_cmd_buffer *cmd, uint64_t dst_va,
+                   uint64_t src_va, uint32_t size, uint32_t data)
+{
+   struct tu_device *device = cmd->device;
+   struct tu_cs *cs = &cmd->cs;
+   const struct tu_buffer_job job = {
+      .dst_va = dst_va,
+      .src_va = src_va,
+      .dwords = size / 4,
+      .data = data,
+   };
+
+   if (!job.dwords)
+      return;
+
+   /* The jobs of a dispatch may run in any order, which is fine because
+    * there has to be a barrier between transfers accessing the same memory.
+    * A barrier without anything emitted yet still leaves pending flushes.
+    */
+   if (cmd->state.buffer_jobs.groups &&
+       cmd->state.buffer_jobs.cs_end == cs->cur &&
+       cmd->state.buffer_jobs.count < TU_BUFFER_JOB_MAX_COUNT &&
+       !cmd->state.cache.flush_bits) {
+      struct tu_buffer_job *jobs =
+         (struct tu_buffer_job *) (cmd->state.buffer_jobs.groups + 4);
+      jobs[cmd->state.buffer_jobs.count++] = job;
+      cmd->state.buffer_jobs.groups[0] = cmd->state.buffer_jobs.count;
+      return;
+   }
+
+   VkPipeline pipeline;
+   VkPipelineLayout layout;
+   VkResult result = get_buffer_jobs_pipeline(device, &pipeline, &layout);
+   if (result != VK_SUCCESS) {
+      vk_command_buffer_set_error(&cmd->vk, result);
+      return;
+   }
+
+   /* VkDispatchIndirectCommand padded to 16 bytes, followed by the jobs. */
+   struct tu_cs_memory list;
+   result = tu_cs_alloc(&cmd->sub_cs,
+                        DIV_ROUND_UP(16 + TU_BUFFER_JOB_MAX_COUNT *
+                                     sizeof(struct tu_buffer_job), 64),
+                        64 / 4, &list);
+   if (result != VK_SUCCESS) {
+      vk_command_buffer_set_error(&cmd->vk, result);
+      return;
+   }
+
+   list.map[0] = 1;
+   list.map[1] = 1;
+   list.map[2] = 1;
+   list.map[3] = 0;
+   memcpy(list.map + 4, &job, sizeof(job));
+
+   VkCommandBuffer commandBuffer = tu_cmd_buffer_to_handle(cmd);
+   struct tu_saved_compute_state state;
+   tu_save_compute_state(cmd, &state);
+
+   /* Transfers aren't affected by conditional rendering and aren't counted
+    * as compute shader invocations.
+    */
+   if (cmd->state.predication_active) {
+      tu_cs_emit_pkt7(cs, CP_DRAW_PRED_ENABLE_LOCAL, 1);
+      tu_cs_emit(cs, 0);
+   }
+
+   if (cmd->state.compute_counters_running)
+      tu_emit_event_write<CHIP>(cmd, cs, FD_STOP_COMPUTE_CTRS);
+
+   tu_CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+   uint64_t jobs_iova = list.iova + 16;
+   vk_common_CmdPushConstants(commandBuffer, layout,
+                              VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                              sizeof(jobs_iova), &jobs_iova);
+
+   tu_dispatch_indirect_addr(commandBuffer, list.iova);
+
+   if (cmd->state.compute_counters_running)
+      tu_emit_event_write<CHIP>(cmd, cs, FD_START_COMPUTE_CTRS);
+
+   if (cmd->state.predication_active) {
+      tu_cs_emit_pkt7(cs, CP_DRAW_PRED_ENABLE_LOCAL, 1);
+      tu_cs_emit(cs, 1);
+   }
+
+   tu_restore_compute_state(cmd, &state);
+
+   /* The shader stores go through UCHE rather than CCU like blits, which the
+    * barriers after transfers don't account for.
+    */
+   tu_flush_for_access(&cmd->state.cache, TU_ACCESS_UCHE_WRITE,
+                       TU_ACCESS_NONE);
+
+   cmd->state.buffer_jobs.groups = list.map;
+   cmd->state.buffer_jobs.count = 1;
+   cmd->state.buffer_jobs.cs_end = cs->cur;
+}
+
 template <chip CHIP>
 static void
 copy_buffer(struct tu_cmd_buffer *cmd,
@@ -3286,10 +3711,16 @@ tu_CmdCopyBuffer2(VkCommandBuffer commandBuffer,
    bool unaligned_store = false;
    for (unsigned i = 0; i < pCopyBufferInfo->regionCount; ++i) {
       const VkBufferCopy2 *region = &pCopyBufferInfo->pRegions[i];
-      copy_buffer<CHIP>(cmd,
-                  dst_buffer->iova + region->dstOffset,
-                  src_buffer->iova + region->srcOffset,
-                  region->size, 1, &unaligned_store);
+      uint64_t dst_va = dst_buffer->iova + region->dstOffset;
+      uint64_t src_va = src_buffer->iova + region->srcOffset;
+
+      if (tu_buffer_jobs_allowed(cmd, dst_va, src_va, region->size)) {
+         tu_buffer_jobs_add<CHIP>(cmd, dst_va, src_va, region->size, 0);
+         continue;
+      }
+
+      copy_buffer<CHIP>(cmd, dst_va, src_va, region->size, 1,
+                        &unaligned_store);
    }
 
    after_buffer_unaligned_buffer_store<CHIP>(cmd, unaligned_store);
@@ -3314,8 +3745,16 @@ tu_CmdUpdateBuffer(VkCommandBuffer commandBuffer,
       return;
    }
 
-   bool unaligned_store = false;
    memcpy(tmp.map, pData, dataSize);
+
+   if (tu_buffer_jobs_allowed(cmd, buffer->iova + dstOffset, tmp.iova,
+                              dataSize)) {
+      tu_buffer_jobs_add<CHIP>(cmd, buffer->iova + dstOffset, tmp.iova,
+                               dataSize, 0);
+      return;
+   }
+
+   bool unaligned_store = false;
    copy_buffer<CHIP>(cmd, buffer->iova + dstOffset, tmp.iova, dataSize, 4, &unaligned_store);
 
    after_buffer_unaligned_buffer_store<CHIP>(cmd, unaligned_store);
@@ -3335,6 +3774,11 @@ tu_cmd_fill_buffer(VkCommandBuffer commandBuffer,
 
    uint32_t blocks = fillSize / 4;
 
+   if (tu_buffer_jobs_allowed(cmd, dstAddr, 0, blocks * 4)) {
+      tu_buffer_jobs_add<CHIP>(cmd, dstAddr, 0, blocks * 4, data);
+      return;
+   }
+
    bool unaligned_store = false;
    handle_buffer_unaligned_store<CHIP>(cmd, dstAddr, fillSize, &unaligned_store);
 
@@ -4192,6 +4636,33 @@ tu_clear_gmem_attachments(struct tu_cmd_buffer *cmd,
    tu_emit_resolve_group<CHIP>(cmd, cs, &resolve_group);
 }
 
+/* Whether any of the cleared attachments may have its GMEM load/store skipped
+ * in bins without geometry.
+ */
+static bool
+tu_clear_attachments_cond_load_store(struct tu_cmd_buffer *cmd,
+                                     uint32_t attachmentCount,
+                                     const VkClearAttachment *pAttachments)
+{
+   const struct tu_subpass *subpass = cmd->state.subpass;
+   for (uint32_t i = 0; i < attachmentCount; i++) {
+      uint32_t a;
+      if (pAttachments[i].aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) {
+         uint32_t c = pAttachments[i].colorAttachment;
+         a = subpass->color_attachments[c].attachment;
+      } else {
+         a = subpass->depth_stencil_attachment.attachment;
+      }
+      if (a != VK_ATTACHMENT_UNUSED) {
+         const struct tu_render_pass_attachment *att = &cmd->state.pass->attachments[a];
+         if (att->cond_load_allowed || att->cond_store_allowed)
+            return true;
+      }
+   }
+
+   return false;
+}
+
 template <chip CHIP>
 static void
 tu_clear_attachments(struct tu_cmd_buffer *cmd,
@@ -4224,22 +4695,10 @@ tu_clear_attachments(struct tu_cmd_buffer *cmd,
     * binning time, then emit the clear as a 3D draw so that it contributes to
     * that visibility.
    */
-   const struct tu_subpass *subpass = cmd->state.subpass;
-   for (uint32_t i = 0; i < attachmentCount; i++) {
-      uint32_t a;
-      if (pAttachments[i].aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) {
-         uint32_t c = pAttachments[i].colorAttachment;
-         a = subpass->color_attachments[c].attachment;
-      } else {
-         a = subpass->depth_stencil_attachment.attachment;
-      }
-      if (a != VK_ATTACHMENT_UNUSED) {
-         const struct tu_render_pass_attachment *att = &cmd->state.pass->attachments[a];
-         if (att->cond_load_allowed || att->cond_store_allowed) {
-            tu_clear_sysmem_attachments<CHIP>(cmd, attachmentCount, pAttachments, rectCount, pRects);
-            return;
-         }
-      }
+   if (tu_clear_attachments_cond_load_store(cmd, attachmentCount,
+                                            pAttachments)) {
+      tu_clear_sysmem_attachments<CHIP>(cmd, attachmentCount, pAttachments, rectCount, pRects);
+      return;
    }
 
    /* Otherwise, emit 2D blits for gmem rendering. */
@@ -4379,7 +4838,13 @@ tu_CmdClearAttachments(VkCommandBuffer commandBuffer,
         * We don't implement it because we don't expect a reasonable impact.
         */
        !(cmd->state.predication_active ||
-         cmd->state.gmem_layout == TU_GMEM_LAYOUT_COUNT)) {
+         cmd->state.gmem_layout == TU_GMEM_LAYOUT_COUNT) &&
+       /* Generic clears aren't draws and aren't seen by the binner, so they
+        * can't be used if an empty bin may skip loading or storing the
+        * cleared attachment.
+        */
+       !tu_clear_attachments_cond_load_store(cmd, attachmentCount,
+                                             pAttachments)) {
       tu_clear_attachments_generic(cmd, attachmentCount, pAttachments, rectCount, pRects);
    } else {
       tu_clear_attachments<CHIP>(cmd, attachmentCount, pAttachments,
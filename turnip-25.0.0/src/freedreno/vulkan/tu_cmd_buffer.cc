@@ -1048,6 +1048,36 @@ tu6_emit_cond_for_load_stores(struct tu_cmd_buffer *cmd, struct tu_cs *cs,
    }
 }
 
+static void
+tu6_emit_dbg_counter_inc(struct tu_cmd_buffer *cmd, struct tu_cs *cs,
+                         uint64_t iova)
+{
+   tu_cs_emit_pkt7(cs, CP_MEM_TO_MEM, 7);
+   tu_cs_emit(cs, CP_MEM_TO_MEM_0_NEG_B);
+   tu_cs_emit_qw(cs, iova);
+   tu_cs_emit_qw(cs, iova);
+   tu_cs_emit_qw(cs, global_iova(cmd, dbg_one));
+}
+
+/* For TU_DEBUG=log_skip_gmem_ops, count the bins whose loads and stores may
+ * be skipped and how many of them had geometry, using the predicate set by
+ * tu6_emit_cond_for_load_stores().
+ */
+static void
+tu6_emit_dbg_bin_stats(struct tu_cmd_buffer *cmd, struct tu_cs *cs)
+{
+   if (!TU_DEBUG(LOG_SKIP_GMEM_OPS) ||
+       !cmd->state.tiling->binning_possible ||
+       !cmd->state.pass->has_cond_load_store)
+      return;
+
+   tu6_emit_dbg_counter_inc(cmd, cs, global_iova(cmd, dbg_gmem_total_bins));
+
+   tu_cond_exec_start(cs, CP_COND_REG_EXEC_0_MODE(PRED_TEST));
+   tu6_emit_dbg_counter_inc(cmd, cs, global_iova(cmd, dbg_gmem_taken_bins));
+   tu_cond_exec_end(cs);
+}
+
 template <chip CHIP>
 static void
 tu6_emit_tile_select(struct tu_cmd_buffer *cmd,
@@ -2265,6 +2295,7 @@ tu6_render_tile(struct tu_cmd_buffer *cmd, struct tu_cs *cs,
                 const struct tu_image_view *fdm)
 {
    tu6_emit_tile_select<CHIP>(cmd, &cmd->cs, tx, ty, pipe, slot, fdm);
+   tu6_emit_dbg_bin_stats(cmd, cs);
    tu_lrz_before_tile<CHIP>(cmd, &cmd->cs);
 
    trace_start_draw_ib_gmem(&cmd->trace, &cmd->cs);
@@ -2347,6 +2378,9 @@ tu_cmd_render_tiles(struct tu_cmd_buffer *cmd,
 
    cmd->trace_renderpass_end = u_trace_end_iterator(&cmd->trace);
 
+   tu_autotune_begin_renderpass_time<CHIP>(cmd, &cmd->cs, autotune_result,
+                                           false);
+
    tu6_tile_render_begin<CHIP>(cmd, &cmd->cs, autotune_result);
 
    /* Note: we reverse the order of walking the pipes and tiles on every
@@ -2384,6 +2418,8 @@ tu_cmd_render_tiles(struct tu_cmd_buffer *cmd,
 
    tu6_tile_render_end<CHIP>(cmd, &cmd->cs, autotune_result);
 
+   tu_autotune_end_renderpass_time<CHIP>(cmd, &cmd->cs, autotune_result);
+
    tu_trace_end_render_pass<CHIP>(cmd, true);
 
    /* We have trashed the dynamically-emitted viewport, scissor, and FS params
@@ -2411,6 +2447,9 @@ tu_cmd_render_sysmem(struct tu_cmd_buffer *cmd,
 {
    cmd->trace_renderpass_end = u_trace_end_iterator(&cmd->trace);
 
+   tu_autotune_begin_renderpass_time<CHIP>(cmd, &cmd->cs, autotune_result,
+                                           true);
+
    tu6_sysmem_render_begin<CHIP>(cmd, &cmd->cs, autotune_result);
 
    trace_start_draw_ib_sysmem(&cmd->trace, &cmd->cs);
@@ -2421,6 +2460,8 @@ tu_cmd_render_sysmem(struct tu_cmd_buffer *cmd,
 
    tu6_sysmem_render_end<CHIP>(cmd, &cmd->cs, autotune_result);
 
+   tu_autotune_end_renderpass_time<CHIP>(cmd, &cmd->cs, autotune_result);
+
    tu_trace_end_render_pass<CHIP>(cmd, false);
 }
 
@@ -2443,6 +2484,8 @@ tu_cmd_render(struct tu_cmd_buffer *cmd_buffer)
     */
    tu_disable_draw_states(cmd_buffer, &cmd_buffer->cs);
 
+   /* The render pass may have programmed the 2D blit state. */
+   cmd_buffer->state.r2d_state.valid = false;
 }
 
 static void tu_reset_render_pass(struct tu_cmd_buffer *cmd_buffer)
@@ -2472,6 +2515,62 @@ static void tu_reset_render_pass(struct tu_cmd_buffer *cmd_buffer)
    cmd_buffer->patchpoints_ctx = NULL;
 }
 
+VKAPI_ATTR VkResult VKAPI_CALL
+tu_CreateCommandPool(VkDevice _device,
+                     const VkCommandPoolCreateInfo *pCreateInfo,
+                     const VkAllocationCallbacks *pAllocator,
+                     VkCommandPool *pCommandPool)
+{
+   VK_FROM_HANDLE(tu_device, device, _device);
+   struct tu_cmd_pool *pool;
+
+   pool = (struct tu_cmd_pool *) vk_alloc2(
+      &device->vk.alloc, pAllocator, sizeof(*pool), 8,
+      VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   if (pool == NULL)
+      return vk_error(device, VK_ERROR_OUT_OF_HOST_MEMORY);
+
+   VkResult result = vk_command_pool_init(&device->vk, &pool->vk,
+                                          pCreateInfo, pAllocator);
+   if (result != VK_SUCCESS) {
+      vk_free2(&device->vk.alloc, pAllocator, pool);
+      return result;
+   }
+
+   tu_cs_bo_pool_init(&pool->cs_bo_pool, device);
+
+   *pCommandPool = tu_cmd_pool_to_handle(pool);
+
+   return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+tu_DestroyCommandPool(VkDevice _device,
+                      VkCommandPool commandPool,
+                      const VkAllocationCallbacks *pAllocator)
+{
+   VK_FROM_HANDLE(tu_device, device, _device);
+   VK_FROM_HANDLE(tu_cmd_pool, pool, commandPool);
+
+   if (!pool)
+      return;
+
+   vk_command_pool_finish(&pool->vk);
+   tu_cs_bo_pool_finish(&pool->cs_bo_pool);
+   vk_free2(&device->vk.alloc, pAllocator, pool);
+}
+
+VKAPI_ATTR void VKAPI_CALL
+tu_TrimCommandPool(VkDevice device,
+                   VkCommandPool commandPool,
+                   VkCommandPoolTrimFlags flags)
+{
+   VK_FROM_HANDLE(tu_cmd_pool, pool, commandPool);
+
+   vk_command_pool_trim(&pool->vk, flags);
+   tu_cs_bo_pool_trim(&pool->cs_bo_pool);
+}
+
 static VkResult
 tu_create_cmd_buffer(struct vk_command_pool *pool,
                      VkCommandBufferLevel level,
@@ -2508,6 +2607,16 @@ tu_create_cmd_buffer(struct vk_command_pool *pool,
    tu_cs_init(&cmd_buffer->pre_chain.draw_cs, device, TU_CS_MODE_GROW, 4096, "prechain draw cs");
    tu_cs_init(&cmd_buffer->pre_chain.draw_epilogue_cs, device, TU_CS_MODE_GROW, 4096, "prechain draw epiligoue cs");
 
+   struct tu_cs_bo_pool *bo_pool =
+      &container_of(pool, struct tu_cmd_pool, vk)->cs_bo_pool;
+   cmd_buffer->cs.bo_pool = bo_pool;
+   cmd_buffer->draw_cs.bo_pool = bo_pool;
+   cmd_buffer->tile_store_cs.bo_pool = bo_pool;
+   cmd_buffer->draw_epilogue_cs.bo_pool = bo_pool;
+   cmd_buffer->sub_cs.bo_pool = bo_pool;
+   cmd_buffer->pre_chain.draw_cs.bo_pool = bo_pool;
+   cmd_buffer->pre_chain.draw_epilogue_cs.bo_pool = bo_pool;
+
    for (unsigned i = 0; i < MAX_BIND_POINTS; i++)
       cmd_buffer->descriptors[i].push_set.base.type = VK_OBJECT_TYPE_DESCRIPTOR_SET;
 
@@ -2592,6 +2701,12 @@ tu_reset_cmd_buffer(struct vk_command_buffer *vk_cmd_buffer,
    cmd_buffer->vsc_initialized = false;
    cmd_buffer->prev_fsr_is_null = false;
 
+   /* The cached states point into sub_cs, which was just reset. */
+   memset(cmd_buffer->draw_state_cache, 0,
+          sizeof(cmd_buffer->draw_state_cache));
+   cmd_buffer->draw_state_cache_hits = 0;
+   cmd_buffer->draw_state_cache_bytes_saved = 0;
+
    ralloc_free(cmd_buffer->patchpoints_ctx);
    ralloc_free(cmd_buffer->pre_chain.patchpoints_ctx);
    cmd_buffer->patchpoints_ctx = NULL;
@@ -2644,6 +2759,55 @@ tu_cmd_buffer_begin(struct tu_cmd_buffer *cmd_buffer,
    return VK_SUCCESS;
 }
 
+/* Begin emitting a dynamic draw state of at most \a size dwords. Small
+ * states are emitted into a CPU scratch buffer first, so that
+ * tu_cmd_end_draw_state() can compare them against the draw state cache
+ * without reading back write-combined BO memory.
+ */
+void
+tu_cmd_begin_draw_state(struct tu_cmd_buffer *cmd, uint32_t size,
+                        struct tu_cs *cs)
+{
+   if (size <= TU_DRAW_STATE_CACHE_MAX_DWORDS) {
+      tu_cs_init_external(cs, cmd->device, cmd->draw_state_scratch,
+                          cmd->draw_state_scratch + size, 0, false);
+      tu_cs_begin(cs);
+      tu_cs_reserve_space(cs, size);
+   } else {
+      tu_cs_begin_sub_stream(&cmd->sub_cs, size, cs);
+   }
+}
+
+struct tu_draw_state
+tu_cmd_end_draw_state(struct tu_cmd_buffer *cmd, struct tu_cs *cs)
+{
+   if (cs->start != cmd->draw_state_scratch)
+      return tu_cs_end_draw_state(&cmd->sub_cs, cs);
+
+   uint32_t size = tu_cs_get_size(cs);
+   uint64_t hash = XXH64(cs->start, size * sizeof(uint32_t), 0);
+   struct tu_draw_state_cache_entry *entry =
+      &cmd->draw_state_cache[hash % TU_DRAW_STATE_CACHE_SIZE];
+
+   if (entry->hash == hash && entry->state.size == size &&
+       !memcmp(entry->dwords, cs->start, size * sizeof(uint32_t))) {
+      cmd->draw_state_cache_hits++;
+      cmd->draw_state_cache_bytes_saved += size * sizeof(uint32_t);
+      return entry->state;
+   }
+
+   struct tu_cs sub_cs;
+   tu_cs_begin_sub_stream(&cmd->sub_cs, size, &sub_cs);
+   tu_cs_emit_array(&sub_cs, cs->start, size);
+   struct tu_draw_state state = tu_cs_end_draw_state(&cmd->sub_cs, &sub_cs);
+
+   entry->hash = hash;
+   entry->state = state;
+   memcpy(entry->dwords, cs->start, size * sizeof(uint32_t));
+
+   return state;
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL
 tu_BeginCommandBuffer(VkCommandBuffer commandBuffer,
                       const VkCommandBufferBeginInfo *pBeginInfo)
@@ -3562,6 +3726,14 @@ tu_EndCommandBuffer(VkCommandBuffer commandBuffer)
    tu_cs_end(&cmd_buffer->draw_cs);
    tu_cs_end(&cmd_buffer->draw_epilogue_cs);
 
+   if (TU_DEBUG(PERF) && cmd_buffer->draw_state_cache_hits) {
+      struct tu_device *dev = cmd_buffer->device;
+      p_atomic_add(&dev->dbg_draw_state_cache_hits,
+                   cmd_buffer->draw_state_cache_hits);
+      p_atomic_add(&dev->dbg_draw_state_cache_bytes_saved,
+                   cmd_buffer->draw_state_cache_bytes_saved);
+   }
+
    return vk_command_buffer_end(&cmd_buffer->vk);
 }
 TU_GENX(tu_EndCommandBuffer);
@@ -3681,11 +3853,29 @@ tu_CmdBindPipeline(VkCommandBuffer commandBuffer,
    cmd->state.dirty |= TU_CMD_DIRTY_DESC_SETS | TU_CMD_DIRTY_SHADER_CONSTS |
                        TU_CMD_DIRTY_VS_PARAMS | TU_CMD_DIRTY_PROGRAM;
 
-   tu_bind_vs(cmd, pipeline->shaders[MESA_SHADER_VERTEX]);
-   tu_bind_tcs(cmd, pipeline->shaders[MESA_SHADER_TESS_CTRL]);
-   tu_bind_tes(cmd, pipeline->shaders[MESA_SHADER_TESS_EVAL]);
-   tu_bind_gs(cmd, pipeline->shaders[MESA_SHADER_GEOMETRY]);
-   tu_bind_fs(cmd, pipeline->shaders[MESA_SHADER_FRAGMENT]);
+   /* Binding a pipeline unbinds all graphics shader objects. */
+   memset(cmd->state.shader_objects, 0, sizeof(cmd->state.shader_objects));
+   cmd->state.dirty &= ~TU_CMD_DIRTY_SHADER_OBJECTS;
+
+   /* Fast-linked pipelines switch to their link-time optimized program once
+    * it has been compiled in the background.
+    */
+   const struct tu_program_state *program = &pipeline->program;
+   struct tu_shader *const *shaders = pipeline->shaders;
+   if (gfx_pipeline->lto) {
+      const struct tu_pipeline_lto *lto =
+         tu_pipeline_lto_bind(cmd->device, gfx_pipeline);
+      if (lto) {
+         program = &lto->program;
+         shaders = lto->shaders;
+      }
+   }
+
+   tu_bind_vs(cmd, shaders[MESA_SHADER_VERTEX]);
+   tu_bind_tcs(cmd, shaders[MESA_SHADER_TESS_CTRL]);
+   tu_bind_tes(cmd, shaders[MESA_SHADER_TESS_EVAL]);
+   tu_bind_gs(cmd, shaders[MESA_SHADER_GEOMETRY]);
+   tu_bind_fs(cmd, shaders[MESA_SHADER_FRAGMENT]);
 
    /* We precompile static state and count it as dynamic, so we have to
     * manually clear bitset that tells which dynamic state is set, in order to
@@ -3700,7 +3890,7 @@ tu_CmdBindPipeline(VkCommandBuffer commandBuffer,
 
    vk_cmd_set_dynamic_graphics_state(&cmd->vk,
                                      &gfx_pipeline->dynamic_state);
-   cmd->state.program = pipeline->program;
+   cmd->state.program = *program;
 
    cmd->state.load_state = pipeline->load_state;
    cmd->state.prim_order_gmem = pipeline->prim_order.state_gmem;
@@ -3731,15 +3921,15 @@ tu_CmdBindPipeline(VkCommandBuffer commandBuffer,
       uint32_t mask = pipeline->set_state_mask;
 
       tu_cs_emit_pkt7(cs, CP_SET_DRAW_STATE, 3 * (10 + util_bitcount(mask)));
-      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_PROGRAM_CONFIG, pipeline->program.config_state);
-      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_VS, pipeline->program.vs_state);
-      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_VS_BINNING, pipeline->program.vs_binning_state);
-      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_HS, pipeline->program.hs_state);
-      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_DS, pipeline->program.ds_state);
-      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_GS, pipeline->program.gs_state);
-      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_GS_BINNING, pipeline->program.gs_binning_state);
-      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_FS, pipeline->program.fs_state);
-      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_VPC, pipeline->program.vpc_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_PROGRAM_CONFIG, program->config_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_VS, program->vs_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_VS_BINNING, program->vs_binning_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_HS, program->hs_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_DS, program->ds_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_GS, program->gs_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_GS_BINNING, program->gs_binning_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_FS, program->fs_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_VPC, program->vpc_state);
       tu_cs_emit_draw_state(cs, TU_DRAW_STATE_PRIM_MODE_GMEM, pipeline->prim_order.state_gmem);
 
       u_foreach_bit(i, mask)
@@ -3750,8 +3940,8 @@ tu_CmdBindPipeline(VkCommandBuffer commandBuffer,
    u_foreach_bit(i, pipeline->set_state_mask)
       cmd->state.dynamic_state[i] = pipeline->dynamic_state[i];
 
-   if (pipeline->program.per_view_viewport != cmd->state.per_view_viewport) {
-      cmd->state.per_view_viewport = pipeline->program.per_view_viewport;
+   if (program->per_view_viewport != cmd->state.per_view_viewport) {
+      cmd->state.per_view_viewport = program->per_view_viewport;
       cmd->state.dirty |= TU_CMD_DIRTY_PER_VIEW_VIEWPORT;
    }
 
@@ -3760,18 +3950,18 @@ tu_CmdBindPipeline(VkCommandBuffer commandBuffer,
       cmd->state.dirty |= TU_CMD_DIRTY_FEEDBACK_LOOPS | TU_CMD_DIRTY_LRZ;
    }
 
-   if (pipeline->program.writes_shading_rate !=
+   if (program->writes_shading_rate !=
           cmd->state.pipeline_writes_shading_rate ||
-       pipeline->program.reads_shading_rate !=
+       program->reads_shading_rate !=
           cmd->state.pipeline_reads_shading_rate ||
-       pipeline->program.accesses_smask !=
+       program->accesses_smask !=
           cmd->state.pipeline_accesses_smask) {
       cmd->state.pipeline_writes_shading_rate =
-         pipeline->program.writes_shading_rate;
+         program->writes_shading_rate;
       cmd->state.pipeline_reads_shading_rate =
-         pipeline->program.reads_shading_rate;
+         program->reads_shading_rate;
       cmd->state.pipeline_accesses_smask =
-         pipeline->program.accesses_smask;
+         program->accesses_smask;
       cmd->state.dirty |= TU_CMD_DIRTY_SHADING_RATE;
    }
 
@@ -3788,6 +3978,41 @@ tu_CmdBindPipeline(VkCommandBuffer commandBuffer,
    }
 }
 
+void
+tu_cmd_bind_shaders(struct vk_command_buffer *vk_cmd,
+                    uint32_t stage_count,
+                    const gl_shader_stage *stages,
+                    struct vk_shader ** const shaders)
+{
+   struct tu_cmd_buffer *cmd =
+      container_of(vk_cmd, struct tu_cmd_buffer, vk);
+
+   for (uint32_t i = 0; i < stage_count; i++) {
+      struct tu_shader_object *obj = shaders[i] ?
+         container_of(shaders[i], struct tu_shader_object, vk) : NULL;
+
+      if (stages[i] == MESA_SHADER_COMPUTE) {
+         if (!obj)
+            continue;
+
+         struct tu_shader *shader =
+            obj->variants[TU_SHADER_OBJECT_VARIANT_DEFAULT];
+         cmd->state.shaders[MESA_SHADER_COMPUTE] = shader;
+         tu_cs_emit_state_ib(&cmd->cs, shader->state);
+         cmd->state.compute_load_state = {};
+         continue;
+      }
+
+      if (stages[i] > MESA_SHADER_FRAGMENT)
+         continue;
+
+      if (cmd->state.shader_objects[stages[i]] != obj) {
+         cmd->state.shader_objects[stages[i]] = obj;
+         cmd->state.dirty |= TU_CMD_DIRTY_SHADER_OBJECTS;
+      }
+   }
+}
+
 void
 tu_flush_for_access(struct tu_cache_state *cache,
                     enum tu_cmd_access_mask src_mask,
@@ -4384,6 +4609,9 @@ tu_CmdExecuteCommands(VkCommandBuffer commandBuffer,
       TU_CALLX(cmd->device, tu_emit_cache_flush)(cmd);
    }
 
+   /* Secondaries may program the 2D blit state. */
+   cmd->state.r2d_state.valid = false;
+
    for (uint32_t i = 0; i < commandBufferCount; i++) {
       VK_FROM_HANDLE(tu_cmd_buffer, secondary, pCmdBuffers[i]);
 
@@ -5790,6 +6018,135 @@ tu_flush_dynamic_input_attachments(struct tu_cmd_buffer *cmd)
    }
 }
 
+/* Pick the variants of the bound shader objects matching each other, and
+ * emit the program state that a pipeline would have precompiled.
+ */
+template <chip CHIP>
+static void
+tu_link_shader_objects(struct tu_cmd_buffer *cmd, struct tu_cs *cs)
+{
+   struct tu_device *dev = cmd->device;
+   struct tu_shader_object **objs = cmd->state.shader_objects;
+   struct tu_shader *shaders[MESA_SHADER_STAGES] = {};
+
+   unsigned tessellation = objs[MESA_SHADER_TESS_EVAL] ?
+      objs[MESA_SHADER_TESS_EVAL]->tessellation : IR3_TESS_NONE;
+   bool has_gs = objs[MESA_SHADER_GEOMETRY];
+
+   for (gl_shader_stage stage = MESA_SHADER_VERTEX;
+        stage <= MESA_SHADER_FRAGMENT; stage = (gl_shader_stage) (stage + 1)) {
+      if (objs[stage]) {
+         shaders[stage] =
+            tu_shader_object_variant(objs[stage], tessellation, has_gs);
+      }
+   }
+
+   if (!tessellation) {
+      shaders[MESA_SHADER_TESS_CTRL] = dev->empty_tcs;
+      shaders[MESA_SHADER_TESS_EVAL] = dev->empty_tes;
+   }
+   if (!shaders[MESA_SHADER_GEOMETRY])
+      shaders[MESA_SHADER_GEOMETRY] = dev->empty_gs;
+   if (!shaders[MESA_SHADER_FRAGMENT]) {
+      shaders[MESA_SHADER_FRAGMENT] =
+         cmd->state.pass && cmd->state.pass->has_fdm ?
+         dev->empty_fs_fdm : dev->empty_fs;
+   }
+
+   tu_bind_vs(cmd, shaders[MESA_SHADER_VERTEX]);
+   tu_bind_tcs(cmd, shaders[MESA_SHADER_TESS_CTRL]);
+   tu_bind_tes(cmd, shaders[MESA_SHADER_TESS_EVAL]);
+   tu_bind_gs(cmd, shaders[MESA_SHADER_GEOMETRY]);
+   tu_bind_fs(cmd, shaders[MESA_SHADER_FRAGMENT]);
+
+   struct tu_program_state *program = &cmd->state.program;
+   *program = {};
+   tu_emit_shader_object_program_state<CHIP>(&cmd->sub_cs, program, shaders,
+                                             cmd->state.vk_rp.view_mask);
+
+   /* There is no precompiled state, so everything a previously bound
+    * pipeline baked in has to be emitted from the dynamic state.
+    */
+   if (cmd->state.pipeline_draw_states || cmd->state.pipeline_blend_lrz ||
+       cmd->state.pipeline_bandwidth) {
+      BITSET_COPY(cmd->vk.dynamic_graphics_state.dirty,
+                  cmd->vk.dynamic_graphics_state.set);
+   }
+   cmd->state.pipeline_draw_states = 0;
+   cmd->state.pipeline_blend_lrz = false;
+   cmd->state.pipeline_bandwidth = false;
+   cmd->state.load_state = {};
+
+   struct tu_cs prim_order_cs;
+   cmd->state.prim_order_gmem =
+      tu_cs_draw_state(&cmd->sub_cs, &prim_order_cs, 2);
+   tu_cs_emit_write_reg(&prim_order_cs, REG_A6XX_GRAS_SC_CNTL,
+                        A6XX_GRAS_SC_CNTL_CCUSINGLECACHELINESIZE(2) |
+                        A6XX_GRAS_SC_CNTL_SINGLE_PRIM_MODE(
+                           TU_DEBUG(RAST_ORDER) ? FLUSH_PER_OVERLAP
+                                                : NO_FLUSH));
+
+   cmd->state.pipeline_sysmem_single_prim_mode = false;
+   cmd->state.pipeline_has_tess = tessellation != IR3_TESS_NONE;
+   cmd->state.pipeline_disable_gmem = false;
+
+   tu_pipeline_update_rp_state(&cmd->state);
+
+   /* note: this also avoids emitting draw states before renderpass clears,
+    * which may use the 3D clear path (for MSAA cases)
+    */
+   if (!(cmd->state.dirty & TU_CMD_DIRTY_DRAW_STATE)) {
+      tu_cs_emit_pkt7(cs, CP_SET_DRAW_STATE, 3 * 10);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_PROGRAM_CONFIG, program->config_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_VS, program->vs_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_VS_BINNING, program->vs_binning_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_HS, program->hs_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_DS, program->ds_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_GS, program->gs_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_GS_BINNING, program->gs_binning_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_FS, program->fs_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_VPC, program->vpc_state);
+      tu_cs_emit_draw_state(cs, TU_DRAW_STATE_PRIM_MODE_GMEM, cmd->state.prim_order_gmem);
+   }
+
+   if (program->per_view_viewport != cmd->state.per_view_viewport) {
+      cmd->state.per_view_viewport = program->per_view_viewport;
+      cmd->state.dirty |= TU_CMD_DIRTY_PER_VIEW_VIEWPORT;
+   }
+
+   if (cmd->state.pipeline_feedback_loops) {
+      cmd->state.pipeline_feedback_loops = 0;
+      cmd->state.dirty |= TU_CMD_DIRTY_FEEDBACK_LOOPS | TU_CMD_DIRTY_LRZ;
+   }
+
+   if (program->writes_shading_rate !=
+          cmd->state.pipeline_writes_shading_rate ||
+       program->reads_shading_rate !=
+          cmd->state.pipeline_reads_shading_rate ||
+       program->accesses_smask !=
+          cmd->state.pipeline_accesses_smask) {
+      cmd->state.pipeline_writes_shading_rate =
+         program->writes_shading_rate;
+      cmd->state.pipeline_reads_shading_rate =
+         program->reads_shading_rate;
+      cmd->state.pipeline_accesses_smask =
+         program->accesses_smask;
+      cmd->state.dirty |= TU_CMD_DIRTY_SHADING_RATE;
+   }
+
+   if (!cmd->state.raster_order_attachment_access_valid ||
+       cmd->state.raster_order_attachment_access) {
+      cmd->state.raster_order_attachment_access = false;
+      cmd->state.dirty |= TU_CMD_DIRTY_RAST_ORDER;
+      cmd->state.raster_order_attachment_access_valid = true;
+   }
+
+   cmd->state.shader_objects_view_mask = cmd->state.vk_rp.view_mask;
+   cmd->state.dirty |= TU_CMD_DIRTY_DESC_SETS | TU_CMD_DIRTY_SHADER_CONSTS |
+                       TU_CMD_DIRTY_VS_PARAMS | TU_CMD_DIRTY_PROGRAM;
+   cmd->state.dirty &= ~TU_CMD_DIRTY_SHADER_OBJECTS;
+}
+
 template <chip CHIP>
 static VkResult
 tu6_draw_common(struct tu_cmd_buffer *cmd,
@@ -5801,6 +6158,11 @@ tu6_draw_common(struct tu_cmd_buffer *cmd,
    const struct tu_program_state *program = &cmd->state.program;
    struct tu_render_pass_state *rp = &cmd->state.rp;
 
+   if (cmd->state.shader_objects[MESA_SHADER_VERTEX] &&
+       ((cmd->state.dirty & TU_CMD_DIRTY_SHADER_OBJECTS) ||
+        cmd->state.shader_objects_view_mask != cmd->state.vk_rp.view_mask))
+      tu_link_shader_objects<CHIP>(cmd, cs);
+
    /* Emit state first, because it's needed for bandwidth calculations */
    uint32_t dynamic_draw_state_dirty = 0;
    if (!BITSET_IS_EMPTY(cmd->vk.dynamic_graphics_state.dirty) ||
@@ -7116,6 +7478,38 @@ tu_dispatch_unaligned_indirect(VkCommandBuffer commandBuffer,
    TU_CALLX(cmd_buffer->device, tu_dispatch)(cmd_buffer, &info);
 }
 
+void
+tu_dispatch_indirect_addr(VkCommandBuffer commandBuffer,
+                          VkDeviceAddress addr)
+{
+   VK_FROM_HANDLE(tu_cmd_buffer, cmd_buffer, commandBuffer);
+   struct tu_dispatch_info info = {};
+
+   info.indirect = addr;
+
+   TU_CALLX(cmd_buffer->device, tu_dispatch)(cmd_buffer, &info);
+}
+
+void
+tu_save_compute_state(struct tu_cmd_buffer *cmd,
+                      struct tu_saved_compute_state *state)
+{
+   memcpy(state->push_constants, cmd->push_constants, sizeof(cmd->push_constants));
+   state->compute_shader = cmd->state.shaders[MESA_SHADER_COMPUTE];
+}
+
+void
+tu_restore_compute_state(struct tu_cmd_buffer *cmd,
+                         struct tu_saved_compute_state *state)
+{
+   cmd->state.shaders[MESA_SHADER_COMPUTE] = state->compute_shader;
+   if (state->compute_shader) {
+      tu_cs_emit_state_ib(&cmd->cs, state->compute_shader->state);
+   }
+   memcpy(cmd->push_constants, state->push_constants, sizeof(cmd->push_constants));
+   cmd->state.dirty |= TU_CMD_DIRTY_SHADER_CONSTS;
+}
+
 VKAPI_ATTR void VKAPI_CALL
 tu_CmdEndRenderPass2(VkCommandBuffer commandBuffer,
                      const VkSubpassEndInfo *pSubpassEndInfo)
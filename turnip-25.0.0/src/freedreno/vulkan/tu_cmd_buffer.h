@@ -75,7 +75,9 @@ enum tu_cmd_dirty_bits
    TU_CMD_DIRTY_FS = BIT(14),
    TU_CMD_DIRTY_SHADING_RATE = BIT(15),
    /* all draw states were disabled and need to be re-enabled: */
-   TU_CMD_DIRTY_DRAW_STATE = BIT(16)
+   TU_CMD_DIRTY_DRAW_STATE = BIT(16),
+   /* the bound graphics shader objects need to be linked before drawing: */
+   TU_CMD_DIRTY_SHADER_OBJECTS = BIT(17),
 };
 
 /* There are only three cache domains we have to care about: the CCU, or
@@ -418,6 +420,12 @@ struct tu_cmd_state
 
    struct tu_shader *shaders[MESA_SHADER_STAGES];
 
+   /* Graphics shader objects bound with vkCmdBindShadersEXT, and the view
+    * mask their program state was last linked with.
+    */
+   struct tu_shader_object *shader_objects[MESA_SHADER_FRAGMENT + 1];
+   uint32_t shader_objects_view_mask;
+
    struct tu_program_state program;
 
    struct tu_render_pass_state rp;
@@ -519,6 +527,18 @@ struct tu_cmd_state
    bool raster_order_attachment_access;
    bool raster_order_attachment_access_valid;
    bool blit_cache_cleaned;
+
+   /* 2D blit state last emitted by r2d_setup() to cs outside of a render
+    * pass, so that consecutive transfers with the same formats don't emit it
+    * again. Invalidated by anything else that may program these registers.
+    */
+   struct {
+      bool valid;
+      uint32_t unknown_8c01;
+      uint32_t blit_cntl;
+      uint32_t dst_format;
+   } r2d_state;
+
    VkImageAspectFlags pipeline_feedback_loops;
    bool pipeline_writes_shading_rate;
    bool pipeline_reads_shading_rate;
@@ -533,8 +553,23 @@ struct tu_cmd_state
     */
    uint32_t prim_counters_running;
 
+   /* Pipeline statistics queries counting compute shader invocations, which
+    * internal dispatches must not be accounted to.
+    */
+   uint32_t compute_counters_running;
+
    bool prim_generated_query_running_before_rp;
 
+   /* Small buffer copies and fills executed by a single indirect dispatch,
+    * see tu_buffer_jobs_add(). Jobs can only be appended while nothing else
+    * was recorded since the dispatch, which is at cs_end.
+    */
+   struct {
+      uint32_t *groups;
+      uint32_t count;
+      uint32_t *cs_end;
+   } buffer_jobs;
+
    enum tu_suspend_resume_state suspend_resume;
 
    bool suspending, resuming;
@@ -551,6 +586,20 @@ struct tu_cmd_state
    uint64_t descriptor_buffer_iova[MAX_SETS];
 };
 
+/* Dynamic draw states up to this size are looked up in a small per command
+ * buffer cache of recently emitted states, so that flipping back and forth
+ * between the same values re-references the copy already in sub_cs.
+ */
+#define TU_DRAW_STATE_CACHE_SIZE 16
+#define TU_DRAW_STATE_CACHE_MAX_DWORDS 64
+
+struct tu_draw_state_cache_entry
+{
+   uint64_t hash;
+   struct tu_draw_state state;
+   uint32_t dwords[TU_DRAW_STATE_CACHE_MAX_DWORDS];
+};
+
 struct tu_cmd_buffer
 {
    struct vk_command_buffer vk;
@@ -597,6 +646,11 @@ struct tu_cmd_buffer
    struct tu_cs draw_epilogue_cs;
    struct tu_cs sub_cs;
 
+   struct tu_draw_state_cache_entry draw_state_cache[TU_DRAW_STATE_CACHE_SIZE];
+   uint32_t draw_state_scratch[TU_DRAW_STATE_CACHE_MAX_DWORDS];
+   uint32_t draw_state_cache_hits;
+   uint32_t draw_state_cache_bytes_saved;
+
    /* If the first render pass in the command buffer is resuming, then it is
     * part of a suspend/resume chain that starts before the current command
     * buffer and needs to be merged later. In this case, its incomplete state
@@ -628,6 +682,16 @@ struct tu_cmd_buffer
 VK_DEFINE_HANDLE_CASTS(tu_cmd_buffer, vk.base, VkCommandBuffer,
                        VK_OBJECT_TYPE_COMMAND_BUFFER)
 
+struct tu_cmd_pool
+{
+   struct vk_command_pool vk;
+
+   /* BOs for the command streams of the pool's command buffers */
+   struct tu_cs_bo_pool cs_bo_pool;
+};
+VK_DEFINE_NONDISP_HANDLE_CASTS(tu_cmd_pool, vk.base, VkCommandPool,
+                               VK_OBJECT_TYPE_COMMAND_POOL)
+
 extern const struct vk_command_buffer_ops tu_cmd_buffer_ops;
 
 static inline uint32_t
@@ -657,6 +721,13 @@ void tu_render_pass_state_merge(struct tu_render_pass_state *dst,
 VkResult tu_cmd_buffer_begin(struct tu_cmd_buffer *cmd_buffer,
                              const VkCommandBufferBeginInfo *pBeginInfo);
 
+void
+tu_cmd_begin_draw_state(struct tu_cmd_buffer *cmd, uint32_t size,
+                        struct tu_cs *cs);
+
+struct tu_draw_state
+tu_cmd_end_draw_state(struct tu_cmd_buffer *cmd, struct tu_cs *cs);
+
 template <chip CHIP>
 void
 tu_emit_cache_flush(struct tu_cmd_buffer *cmd_buffer);
@@ -688,12 +759,32 @@ tu_restore_suspended_pass(struct tu_cmd_buffer *cmd,
 template <chip CHIP>
 void tu_cmd_render(struct tu_cmd_buffer *cmd);
 
+void tu_cmd_bind_shaders(struct vk_command_buffer *vk_cmd,
+                         uint32_t stage_count,
+                         const gl_shader_stage *stages,
+                         struct vk_shader ** const shaders);
+
 void tu_dispatch_unaligned(VkCommandBuffer commandBuffer,
                            uint32_t x, uint32_t y, uint32_t z);
 
 void tu_dispatch_unaligned_indirect(VkCommandBuffer commandBuffer,
                                     VkDeviceAddress size_addr);
 
+void tu_dispatch_indirect_addr(VkCommandBuffer commandBuffer,
+                               VkDeviceAddress addr);
+
+/* Compute state clobbered by internal dispatches. */
+struct tu_saved_compute_state {
+   uint32_t push_constants[MAX_PUSH_CONSTANTS_SIZE / 4];
+   struct tu_shader *compute_shader;
+};
+
+void tu_save_compute_state(struct tu_cmd_buffer *cmd,
+                           struct tu_saved_compute_state *state);
+
+void tu_restore_compute_state(struct tu_cmd_buffer *cmd,
+                              struct tu_saved_compute_state *state);
+
 void tu_write_buffer_cp(VkCommandBuffer commandBuffer,
                         VkDeviceAddress addr,
                         void *data, uint32_t size);
@@ -65,22 +65,106 @@ tu_cs_init_suballoc(struct tu_cs *cs, struct tu_device *device,
    cs->refcount_bo = tu_bo_get_ref(suballoc_bo->bo);
 }
 
+void
+tu_cs_bo_pool_init(struct tu_cs_bo_pool *pool, struct tu_device *device)
+{
+   memset(pool, 0, sizeof(*pool));
+   pool->device = device;
+   util_dynarray_init(&pool->free_bos[0], NULL);
+   util_dynarray_init(&pool->free_bos[1], NULL);
+}
+
+static void
+tu_cs_bo_pool_free_idle(struct tu_cs_bo_pool *pool, uint64_t max_free_size)
+{
+   for (unsigned i = 0; i < ARRAY_SIZE(pool->free_bos); i++) {
+      while (pool->free_size > max_free_size &&
+             util_dynarray_contains(&pool->free_bos[i], struct tu_bo *)) {
+         struct tu_bo *bo =
+            util_dynarray_pop(&pool->free_bos[i], struct tu_bo *);
+         pool->free_size -= bo->size;
+         TU_RMV(resource_destroy, pool->device, bo);
+         tu_bo_finish(pool->device, bo);
+      }
+   }
+}
+
+void
+tu_cs_bo_pool_finish(struct tu_cs_bo_pool *pool)
+{
+   assert(pool->used_size == 0);
+   tu_cs_bo_pool_free_idle(pool, 0);
+   util_dynarray_fini(&pool->free_bos[0]);
+   util_dynarray_fini(&pool->free_bos[1]);
+}
+
 /**
- * Finish and release all resources owned by a command stream.
+ * Free all idle BOs and let the high water mark be learned again.
  */
 void
-tu_cs_finish(struct tu_cs *cs)
+tu_cs_bo_pool_trim(struct tu_cs_bo_pool *pool)
 {
-   for (uint32_t i = 0; i < cs->read_only.bo_count; ++i) {
-      TU_RMV(resource_destroy, cs->device, cs->read_only.bos[i]);
-      tu_bo_finish(cs->device, cs->read_only.bos[i]);
+   tu_cs_bo_pool_free_idle(pool, 0);
+   pool->high_water_size = pool->used_size;
+}
+
+static struct tu_bo *
+tu_cs_bo_pool_get(struct tu_cs_bo_pool *pool, uint64_t size, bool writeable)
+{
+   struct util_dynarray *free_bos = &pool->free_bos[writeable];
+
+   /* Reuse the most recently freed BO which is big enough without wasting
+    * more than half of it, since sizes only grow within a command stream.
+    */
+   util_dynarray_foreach_reverse (free_bos, struct tu_bo *, bo_ptr) {
+      struct tu_bo *bo = *bo_ptr;
+      if (bo->size >= size && bo->size / 2 < size) {
+         *bo_ptr = util_dynarray_pop(free_bos, struct tu_bo *);
+         pool->free_size -= bo->size;
+         pool->used_size += bo->size;
+         return bo;
+      }
    }
 
-   for (uint32_t i = 0; i < cs->read_write.bo_count; ++i) {
-      TU_RMV(resource_destroy, cs->device, cs->read_write.bos[i]);
-      tu_bo_finish(cs->device, cs->read_write.bos[i]);
+   return NULL;
+}
+
+static void
+tu_cs_free_bo(struct tu_cs *cs, struct tu_bo *bo, bool writeable)
+{
+   struct tu_cs_bo_pool *pool = cs->bo_pool;
+
+   if (!pool) {
+      TU_RMV(resource_destroy, cs->device, bo);
+      tu_bo_finish(cs->device, bo);
+      return;
    }
 
+   pool->used_size -= bo->size;
+
+   if (p_atomic_read(&bo->refcnt) != 1 ||
+       pool->used_size + pool->free_size + bo->size > pool->high_water_size) {
+      TU_RMV(resource_destroy, cs->device, bo);
+      tu_bo_finish(cs->device, bo);
+      return;
+   }
+
+   util_dynarray_append(&pool->free_bos[writeable], struct tu_bo *, bo);
+   pool->free_size += bo->size;
+}
+
+/**
+ * Finish and release all resources owned by a command stream.
+ */
+void
+tu_cs_finish(struct tu_cs *cs)
+{
+   for (uint32_t i = 0; i < cs->read_only.bo_count; ++i)
+      tu_cs_free_bo(cs, cs->read_only.bos[i], false);
+
+   for (uint32_t i = 0; i < cs->read_write.bo_count; ++i)
+      tu_cs_free_bo(cs, cs->read_write.bos[i], true);
+
    if (cs->refcount_bo)
       tu_bo_finish(cs->device, cs->refcount_bo);
 
@@ -153,25 +237,38 @@ tu_cs_add_bo(struct tu_cs *cs, uint32_t size)
       bos->bos = new_bos;
    }
 
-   struct tu_bo *new_bo;
-
-   VkResult result =
-      tu_bo_init_new(cs->device, NULL, &new_bo, size * sizeof(uint32_t),
-                     (enum tu_bo_alloc_flags)(COND(!cs->writeable,
-                                                   TU_BO_ALLOC_GPU_READ_ONLY) |
-                                              TU_BO_ALLOC_ALLOW_DUMP),
-                     cs->name);
-   if (result != VK_SUCCESS) {
-      return result;
+   struct tu_bo *new_bo = NULL;
+   if (cs->bo_pool) {
+      new_bo = tu_cs_bo_pool_get(cs->bo_pool, size * sizeof(uint32_t),
+                                 cs->writeable);
    }
 
-   result = tu_bo_map(cs->device, new_bo, NULL);
-   if (result != VK_SUCCESS) {
-      tu_bo_finish(cs->device, new_bo);
-      return result;
-   }
+   if (!new_bo) {
+      VkResult result =
+         tu_bo_init_new(cs->device, NULL, &new_bo, size * sizeof(uint32_t),
+                        (enum tu_bo_alloc_flags)(COND(!cs->writeable,
+                                                      TU_BO_ALLOC_GPU_READ_ONLY) |
+                                                 TU_BO_ALLOC_ALLOW_DUMP |
+                                                 TU_BO_ALLOC_RECYCLABLE),
+                        cs->name);
+      if (result != VK_SUCCESS) {
+         return result;
+      }
+
+      result = tu_bo_map(cs->device, new_bo, NULL);
+      if (result != VK_SUCCESS) {
+         tu_bo_finish(cs->device, new_bo);
+         return result;
+      }
 
-   TU_RMV(cmd_buffer_bo_create, cs->device, new_bo);
+      TU_RMV(cmd_buffer_bo_create, cs->device, new_bo);
+
+      if (cs->bo_pool) {
+         cs->bo_pool->used_size += new_bo->size;
+         cs->bo_pool->high_water_size =
+            MAX2(cs->bo_pool->high_water_size, cs->bo_pool->used_size);
+      }
+   }
 
    bos->bos[bos->bo_count++] = new_bo;
 
@@ -500,15 +597,11 @@ tu_cs_reset(struct tu_cs *cs)
       return;
    }
 
-   for (uint32_t i = 0; i + 1 < cs->read_only.bo_count; ++i) {
-      TU_RMV(resource_destroy, cs->device, cs->read_only.bos[i]);
-      tu_bo_finish(cs->device, cs->read_only.bos[i]);
-   }
+   for (uint32_t i = 0; i + 1 < cs->read_only.bo_count; ++i)
+      tu_cs_free_bo(cs, cs->read_only.bos[i], false);
 
-   for (uint32_t i = 0; i + 1 < cs->read_write.bo_count; ++i) {
-      TU_RMV(resource_destroy, cs->device, cs->read_write.bos[i]);
-      tu_bo_finish(cs->device, cs->read_write.bos[i]);
-   }
+   for (uint32_t i = 0; i + 1 < cs->read_write.bo_count; ++i)
+      tu_cs_free_bo(cs, cs->read_write.bos[i], true);
 
    cs->writeable = false;
 
@@ -78,6 +78,24 @@ struct tu_bo_array {
    uint32_t *start;
 };
 
+/* Idle command stream BOs owned by a command pool. Command pools are
+ * externally synchronized, so BOs can be recycled between the pool's command
+ * buffers without taking any device-wide lock.
+ */
+struct tu_cs_bo_pool {
+   struct tu_device *device;
+
+   /* Idle BOs, indexed by whether they are writeable */
+   struct util_dynarray free_bos[2];
+   uint64_t free_size;
+
+   /* Size of the BOs currently owned by command streams, and the highest it
+    * has been. Idle BOs are only kept up to the high water mark.
+    */
+   uint64_t used_size;
+   uint64_t high_water_size;
+};
+
 #define TU_COND_EXEC_STACK_SIZE 4
 
 struct tu_cs
@@ -102,6 +120,9 @@ struct tu_cs
    /* Optional BO that this CS is sub-allocated from for TU_CS_MODE_SUB_STREAM */
    struct tu_bo *refcount_bo;
 
+   /* Optional pool that BOs are allocated from and returned to */
+   struct tu_cs_bo_pool *bo_pool;
+
    /* iova that this CS starts with in TU_CS_MODE_EXTERNAL */
    uint64_t external_iova;
 
@@ -137,6 +158,15 @@ tu_cs_init_suballoc(struct tu_cs *cs, struct tu_device *device,
 void
 tu_cs_finish(struct tu_cs *cs);
 
+void
+tu_cs_bo_pool_init(struct tu_cs_bo_pool *pool, struct tu_device *device);
+
+void
+tu_cs_bo_pool_finish(struct tu_cs_bo_pool *pool);
+
+void
+tu_cs_bo_pool_trim(struct tu_cs_bo_pool *pool);
+
 void
 tu_cs_begin(struct tu_cs *cs);
 
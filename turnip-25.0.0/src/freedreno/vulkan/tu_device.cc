@@ -18,8 +18,10 @@
 #include "util/u_debug.h"
 #include "util/disk_cache.h"
 #include "util/hex.h"
+#include "util/os_file.h"
 #include "util/driconf.h"
 #include "util/os_misc.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_process.h"
 #include "vk_android.h"
 #include "vk_shader_module.h"
@@ -309,6 +311,7 @@ get_device_extensions(const struct tu_physical_device *device,
       .EXT_separate_stencil_usage = true,
       .EXT_shader_demote_to_helper_invocation = true,
       .EXT_shader_module_identifier = true,
+      .EXT_shader_object = device->info->a6xx.supports_multiview_mask,
       .EXT_shader_replicated_composites = true,
       .EXT_shader_stencil_export = true,
       .EXT_shader_viewport_index_layer = TU_DEBUG(NOCONFORM) ? true : device->info->a6xx.has_hw_multiview,
@@ -714,6 +717,12 @@ tu_get_features(struct tu_physical_device *pdevice,
    /* VK_EXT_shader_module_identifier */
    features->shaderModuleIdentifier = true;
 
+   /* VK_EXT_shader_object */
+   /* Vertex shader objects are compiled without knowing the view mask, so
+    * they rely on the hardware to mask out inactive views.
+    */
+   features->shaderObject = pdevice->info->a6xx.supports_multiview_mask;
+
    /* VK_EXT_shader_replicated_composites */
    features->shaderReplicatedComposites = true;
 
@@ -1199,6 +1208,10 @@ tu_get_properties(struct tu_physical_device *pdevice,
           vk_shaderModuleIdentifierAlgorithmUUID,
           sizeof(props->shaderModuleIdentifierAlgorithmUUID));
 
+   /* VK_EXT_shader_object */
+   memcpy(props->shaderBinaryUUID, pdevice->cache_uuid, VK_UUID_SIZE);
+   props->shaderBinaryVersion = 1;
+
    /* VK_EXT_map_memory_placed */
    os_get_page_size(&os_page_size);
    props->minPlacedMemoryMapAlignment = os_page_size;
@@ -1362,6 +1375,23 @@ static const struct vk_pipeline_cache_object_ops *const cache_import_ops[] = {
    NULL,
 };
 
+static struct ir3_compiler *
+tu_ir3_compiler_create(struct tu_physical_device *physical_device)
+{
+   struct ir3_compiler_options ir3_options = {
+      .push_ubo_with_preamble = true,
+      .disable_cache = true,
+      .bindless_fb_read_descriptor = -1,
+      .bindless_fb_read_slot = -1,
+      .storage_16bit = physical_device->info->a6xx.storage_16bit,
+      .storage_8bit = physical_device->info->a7xx.storage_8bit,
+      .shared_push_consts = !TU_DEBUG(PUSH_CONSTS_PER_STAGE),
+   };
+
+   return ir3_compiler_create(NULL, &physical_device->dev_id,
+                              physical_device->info, &ir3_options);
+}
+
 VkResult
 tu_physical_device_init(struct tu_physical_device *device,
                         struct tu_instance *instance)
@@ -1460,6 +1490,20 @@ tu_physical_device_init(struct tu_physical_device *device,
       goto fail_free_name;
    }
 
+   /* Shader objects translate SPIR-V before there is a device, so keep a copy
+    * of the NIR options the device's compiler will use.
+    */
+   {
+      struct ir3_compiler *compiler = tu_ir3_compiler_create(device);
+      if (!compiler) {
+         result = vk_startup_errorf(instance, VK_ERROR_INITIALIZATION_FAILED,
+                                    "failed to initialize ir3 compiler");
+         goto fail_free_name;
+      }
+      device->nir_options = *ir3_get_compiler_options(compiler);
+      ir3_compiler_destroy(compiler);
+   }
+
    device->level1_dcache_size = tu_get_l1_dcache_size();
    device->has_cached_non_coherent_memory =
       device->level1_dcache_size > 0 && !DETECT_ARCH_ARM;
@@ -1887,6 +1931,35 @@ tu_GetPhysicalDeviceFragmentShadingRatesKHR(
    return vk_outarray_status(&out);
 }
 
+/* VK_EXT_tooling_info */
+VKAPI_ATTR VkResult VKAPI_CALL
+tu_GetPhysicalDeviceToolProperties(
+   VkPhysicalDevice physicalDevice,
+   uint32_t *pToolCount,
+   VkPhysicalDeviceToolProperties *pToolProperties)
+{
+   VK_OUTARRAY_MAKE_TYPED(VkPhysicalDeviceToolProperties, out,
+                          pToolProperties, pToolCount);
+
+   /* Let capture and profiling tools know that the driver is logging
+    * pipeline cache statistics, which are also exported as trace counters.
+    */
+   if (TU_DEBUG(CACHESTATS)) {
+      vk_outarray_append_typed(VkPhysicalDeviceToolProperties, &out, tool) {
+         snprintf(tool->name, sizeof(tool->name), "Turnip cache statistics");
+         snprintf(tool->version, sizeof(tool->version), "%s",
+                  PACKAGE_VERSION);
+         tool->purposes = VK_TOOL_PURPOSE_PROFILING_BIT;
+         snprintf(tool->description, sizeof(tool->description),
+                  "Pipeline cache hit rates and shader compile times, "
+                  "enabled with TU_DEBUG=cachestats");
+         tool->layer[0] = '\0';
+      }
+   }
+
+   return vk_outarray_status(&out);
+}
+
 uint64_t
 tu_device_ticks_to_ns(struct tu_device *dev, uint64_t ts)
 {
@@ -2384,6 +2457,35 @@ tu_init_cmdbuf_start_a725_quirk(struct tu_device *device)
    return VK_SUCCESS;
 }
 
+/* Set by jobs that may queue further work of their own. */
+thread_local bool tu_in_worker_queue_job;
+
+static void
+tu_worker_queue_init(struct tu_device *device)
+{
+   /* The thread calling into the driver does its share of the work too, so
+    * only spin up threads for the other CPUs. Threads are created on demand
+    * so this costs nothing for apps that never use it.
+    */
+   int num_threads =
+      debug_get_num_option("TU_WORKER_THREADS",
+                           MIN2(util_get_cpu_caps()->nr_cpus, 8) - 1);
+   if (num_threads <= 0)
+      return;
+
+   if (!util_queue_init(&device->worker_queue, "tu_worker", 32, num_threads,
+                        UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL)) {
+      mesa_logw("failed to create worker queue, continuing without it");
+   }
+}
+
+static void
+tu_worker_queue_finish(struct tu_device *device)
+{
+   if (util_queue_is_initialized(&device->worker_queue))
+      util_queue_destroy(&device->worker_queue);
+}
+
 static VkResult
 tu_device_get_timestamp(struct vk_device *vk_device, uint64_t *timestamp)
 {
@@ -2392,6 +2494,93 @@ tu_device_get_timestamp(struct vk_device *vk_device, uint64_t *timestamp)
    return ret == 0 ? VK_SUCCESS : VK_ERROR_UNKNOWN;
 }
 
+/* Pre-warmed caches are usually built on another host, often for another
+ * CPU architecture, so unlike pipelineCacheUUID they can't be keyed on the
+ * build id. Key them on the Mesa version and git revision instead, which
+ * tu_prewarm_cache.py reads back from VkPhysicalDeviceDriverProperties. Keep
+ * both in sync.
+ */
+static void
+tu_device_get_prewarm_uuid(struct tu_physical_device *pdevice, uint8_t *uuid)
+{
+   static const char driver_info[] = "Mesa " PACKAGE_VERSION MESA_GIT_SHA1;
+   uint32_t chip_id = pdevice->dev_id.chip_id;
+   uint64_t driver_flags = TU_DEBUG(NOMULTIPOS);
+   struct mesa_sha1 ctx;
+   unsigned char sha1[20];
+
+   _mesa_sha1_init(&ctx);
+   _mesa_sha1_update(&ctx, driver_info, strlen(driver_info));
+   _mesa_sha1_update(&ctx, &chip_id, sizeof(chip_id));
+   _mesa_sha1_update(&ctx, &driver_flags, sizeof(driver_flags));
+   _mesa_sha1_final(&ctx, sha1);
+
+   memcpy(uuid, sha1, VK_UUID_SIZE);
+}
+
+/* Loads the cache blob named by TU_PREWARM_CACHE. Blobs written for another
+ * GPU or Mesa revision are ignored.
+ */
+static void
+tu_load_prewarm_cache(struct tu_device *device)
+{
+   struct tu_physical_device *pdevice = device->physical_device;
+
+   const char *path = os_get_option("TU_PREWARM_CACHE");
+   if (!path || !*path)
+      return;
+
+   size_t size;
+   char *data = os_read_file(path, &size);
+   if (!data) {
+      mesa_logw("failed to read prewarm cache %s", path);
+      return;
+   }
+
+   uint8_t prewarm_uuid[VK_UUID_SIZE];
+   tu_device_get_prewarm_uuid(pdevice, prewarm_uuid);
+
+   VkPipelineCacheHeaderVersionOne header;
+   if (size < sizeof(header)) {
+      mesa_logw("prewarm cache %s is truncated", path);
+      free(data);
+      return;
+   }
+
+   memcpy(&header, data, sizeof(header));
+   if (header.headerSize < sizeof(header) ||
+       header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+       header.vendorID != 0x5143 ||
+       header.deviceID != (uint32_t) pdevice->dev_id.chip_id ||
+       memcmp(header.pipelineCacheUUID, prewarm_uuid, VK_UUID_SIZE) != 0) {
+      mesa_logw("prewarm cache %s was built for another GPU or Mesa revision",
+                path);
+      free(data);
+      return;
+   }
+
+   /* The objects themselves only depend on the source, hand them to the
+    * runtime as if this build had written them.
+    */
+   memcpy(data + offsetof(VkPipelineCacheHeaderVersionOne, pipelineCacheUUID),
+          pdevice->cache_uuid, VK_UUID_SIZE);
+
+   const VkPipelineCacheCreateInfo create_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+      .initialDataSize = size,
+      .pInitialData = data,
+   };
+   const struct vk_pipeline_cache_create_info pcc_info = {
+      .pCreateInfo = &create_info,
+      .force_enable = true,
+      .skip_disk_cache = true,
+   };
+   device->prewarm_cache =
+      vk_pipeline_cache_create(&device->vk, &pcc_info, NULL);
+
+   free(data);
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL
 tu_CreateDevice(VkPhysicalDevice physicalDevice,
                 const VkDeviceCreateInfo *pCreateInfo,
@@ -2472,6 +2661,7 @@ tu_CreateDevice(VkPhysicalDevice physicalDevice,
    }
 
    device->vk.command_buffer_ops = &tu_cmd_buffer_ops;
+   device->vk.shader_ops = &tu_device_shader_ops;
    device->vk.as_build_ops = &tu_as_build_ops;
    device->vk.check_status = tu_device_check_status;
    device->vk.get_timestamp = tu_device_get_timestamp;
@@ -2540,19 +2730,7 @@ tu_CreateDevice(VkPhysicalDevice physicalDevice,
 
    mtx_init(&device->radix_sort_mutex, mtx_plain);
 
-   {
-      struct ir3_compiler_options ir3_options = {
-         .push_ubo_with_preamble = true,
-         .disable_cache = true,
-         .bindless_fb_read_descriptor = -1,
-         .bindless_fb_read_slot = -1,
-         .storage_16bit = physical_device->info->a6xx.storage_16bit,
-         .storage_8bit = physical_device->info->a7xx.storage_8bit,
-         .shared_push_consts = !TU_DEBUG(PUSH_CONSTS_PER_STAGE),
-      };
-      device->compiler = ir3_compiler_create(
-         NULL, &physical_device->dev_id, physical_device->info, &ir3_options);
-   }
+   device->compiler = tu_ir3_compiler_create(physical_device);
    if (!device->compiler) {
       result = vk_startup_errorf(physical_device->instance,
                                  VK_ERROR_INITIALIZATION_FAILED,
@@ -2574,6 +2752,12 @@ tu_CreateDevice(VkPhysicalDevice physicalDevice,
       }
    }
 
+   tu_bo_cache_init(device);
+   tu_worker_queue_init(device);
+
+   device->background_lto_binds =
+      debug_get_num_option("TU_BACKGROUND_LTO_BINDS", 64);
+
    /* initial sizes, these will increase if there is overflow */
    device->vsc_draw_strm_pitch = 0x1000 + VSC_PAD;
    device->vsc_prim_strm_pitch = 0x4000 + VSC_PAD;
@@ -2638,6 +2822,8 @@ tu_CreateDevice(VkPhysicalDevice physicalDevice,
    global->dbg_gmem_taken_loads = 0;
    global->dbg_gmem_total_stores = 0;
    global->dbg_gmem_taken_stores = 0;
+   global->dbg_gmem_total_bins = 0;
+   global->dbg_gmem_taken_bins = 0;
    for (int i = 0; i < TU_BORDER_COLOR_BUILTIN; i++) {
       VkClearColorValue border_color = vk_border_color_value((VkBorderColor) i);
       tu6_pack_border_color(&global->bcolor_builtin[i], &border_color,
@@ -2661,6 +2847,8 @@ tu_CreateDevice(VkPhysicalDevice physicalDevice,
       goto fail_pipeline_cache;
    }
 
+   tu_load_prewarm_cache(device);
+
    tu_cs_init(&device->sub_cs, device, TU_CS_MODE_SUB_STREAM, 1024, "device sub cs");
 
    if (device->vk.enabled_features.performanceCounterQueryPools) {
@@ -2802,6 +2990,8 @@ fail_prepare_perfcntrs_pass_cs:
    free(device->perfcntrs_pass_cs_entries);
 fail_perfcntrs_pass_entries_alloc:
    tu_cs_finish(&device->sub_cs);
+   if (device->prewarm_cache)
+      vk_pipeline_cache_destroy(device->prewarm_cache, &device->vk.alloc);
    vk_pipeline_cache_destroy(device->mem_cache, &device->vk.alloc);
 fail_pipeline_cache:
    tu_destroy_dynamic_rendering(device);
@@ -2818,6 +3008,8 @@ fail_global_bo_map:
    vk_free(&device->vk.alloc, device->submit_bo_list);
    util_dynarray_fini(&device->dump_bo_list);
 fail_global_bo:
+   tu_worker_queue_finish(device);
+   tu_bo_cache_finish(device);
    if (physical_device->has_set_iova)
       util_vma_heap_finish(&device->vma);
 fail_free_zombie_vma:
@@ -2882,6 +3074,11 @@ tu_DestroyDevice(VkDevice _device, const VkAllocationCallbacks *pAllocator)
 
    ir3_compiler_destroy(device->compiler);
 
+   if (TU_DEBUG(CACHESTATS))
+      tu_pipeline_cache_stats_dump(device, true);
+
+   if (device->prewarm_cache)
+      vk_pipeline_cache_destroy(device->prewarm_cache, &device->vk.alloc);
    vk_pipeline_cache_destroy(device->mem_cache, &device->vk.alloc);
 
    tu_cs_finish(&device->sub_cs);
@@ -2902,6 +3099,8 @@ tu_DestroyDevice(VkDevice _device, const VkAllocationCallbacks *pAllocator)
 
    tu_autotune_fini(&device->autotune, device);
 
+   tu_worker_queue_finish(device);
+
    tu_bo_suballocator_finish(&device->pipeline_suballoc);
    tu_bo_suballocator_finish(&device->autotune_suballoc);
    tu_bo_suballocator_finish(&device->kgsl_profiling_suballoc);
@@ -2911,6 +3110,9 @@ tu_DestroyDevice(VkDevice _device, const VkAllocationCallbacks *pAllocator)
    if (device->null_accel_struct_bo)
       tu_bo_finish(device, device->null_accel_struct_bo);
 
+   /* Must happen before the queues are gone, freeing BOs may need them. */
+   tu_bo_cache_finish(device);
+
    for (unsigned i = 0; i < TU_MAX_QUEUE_FAMILIES; i++) {
       for (unsigned q = 0; q < device->queue_count[i]; q++)
          tu_queue_finish(&device->queues[i][q]);
@@ -3035,6 +3237,7 @@ tu_AllocateMemory(VkDevice _device,
 
    struct tu_memory_heap *mem_heap = &device->physical_device->heap;
    uint64_t mem_heap_used = p_atomic_read(&mem_heap->used);
+   uint64_t heap_size = UINT64_MAX;
    if (mem_heap_used > mem_heap->size)
       return vk_error(device, VK_ERROR_OUT_OF_DEVICE_MEMORY);
 
@@ -3099,6 +3302,11 @@ tu_AllocateMemory(VkDevice _device,
          alloc_flags |= TU_BO_ALLOC_REPLAYABLE;
       }
 
+      /* Replayable and exportable memory is never recycled, see
+       * tu_bo_cache_is_recyclable().
+       */
+      alloc_flags |= TU_BO_ALLOC_RECYCLABLE;
+
       const VkExportMemoryAllocateInfo *export_info =
          vk_find_struct_const(pAllocateInfo->pNext, EXPORT_MEMORY_ALLOCATE_INFO);
       if (export_info && (export_info->handleTypes &
@@ -3116,12 +3324,14 @@ tu_AllocateMemory(VkDevice _device,
       result = tu_bo_init_new_explicit_iova(
          device, &mem->vk.base, &mem->bo, pAllocateInfo->allocationSize,
          client_address, mem_property, alloc_flags, name);
+      heap_size = align64(pAllocateInfo->allocationSize, os_page_size);
    }
 
    if (result == VK_SUCCESS) {
-      mem_heap_used = p_atomic_add_return(&mem_heap->used, mem->bo->size);
+      mem->heap_size = MIN2(mem->bo->size, heap_size);
+      mem_heap_used = p_atomic_add_return(&mem_heap->used, mem->heap_size);
       if (mem_heap_used > mem_heap->size) {
-         p_atomic_add(&mem_heap->used, -mem->bo->size);
+         p_atomic_add(&mem_heap->used, -mem->heap_size);
          tu_bo_finish(device, mem->bo);
          result = vk_errorf(device, VK_ERROR_OUT_OF_DEVICE_MEMORY,
                             "Out of heap memory");
@@ -3175,7 +3385,7 @@ tu_FreeMemory(VkDevice _device,
 
    TU_RMV(resource_destroy, device, mem);
 
-   p_atomic_add(&device->physical_device->heap.used, -mem->bo->size);
+   p_atomic_add(&device->physical_device->heap.used, -mem->heap_size);
    tu_bo_finish(device, mem->bo);
    vk_device_memory_destroy(&device->vk, pAllocator, &mem->vk);
 }
@@ -3328,7 +3538,8 @@ tu_setup_dynamic_framebuffer(struct tu_cmd_buffer *cmd_buffer,
       pRenderingInfo->renderArea.extent.height;
    framebuffer->layers = pRenderingInfo->layerCount;
 
-   tu_framebuffer_tiling_config(framebuffer, cmd_buffer->device, pass);
+   tu_dynamic_tiling_config(cmd_buffer->device, pass, framebuffer);
+   tu_render_pass_calc_hash(pass);
 }
 
 VKAPI_ATTR void VKAPI_CALL
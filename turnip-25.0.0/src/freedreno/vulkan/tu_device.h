@@ -26,6 +26,7 @@
 
 #include "common/freedreno_rd_output.h"
 #include "util/vma.h"
+#include "util/u_queue.h"
 #include "util/u_vector.h"
 
 /* queue types */
@@ -87,6 +88,9 @@ struct tu_physical_device
    uint8_t device_uuid[VK_UUID_SIZE];
    uint8_t cache_uuid[VK_UUID_SIZE];
 
+   /* NIR options of the device's ir3 compiler, for VK_EXT_shader_object */
+   struct nir_shader_compiler_options nir_options;
+
    struct wsi_device wsi_device;
 
    char fd_path[20];
@@ -245,6 +249,8 @@ struct tu6_global
    volatile uint32_t dbg_gmem_taken_loads;
    volatile uint32_t dbg_gmem_total_stores;
    volatile uint32_t dbg_gmem_taken_stores;
+   volatile uint32_t dbg_gmem_total_bins;
+   volatile uint32_t dbg_gmem_taken_bins;
 
    /* Written from GPU */
    volatile uint32_t breadcrumb_gpu_sync_seqno;
@@ -290,6 +296,11 @@ struct tu_device
    /* Backup in-memory cache to be used if the app doesn't provide one */
    struct vk_pipeline_cache *mem_cache;
 
+   /* Read-only cache pre-warmed offline by tu_prewarm_cache.py, consulted
+    * on cache misses.
+    */
+   struct vk_pipeline_cache *prewarm_cache;
+
    struct vk_meta_device meta;
 
    radix_sort_vk_t *radix_sort;
@@ -393,6 +404,14 @@ struct tu_device
     */
    struct u_vector zombie_vmas;
 
+   /* Idle BOs kept around for reuse by new allocations. */
+   struct tu_bo_cache bo_cache;
+
+   /* Worker threads used to split up CPU-heavy work, such as large host
+    * image copies. Not initialized if there are no spare CPUs.
+    */
+   struct util_queue worker_queue;
+
    struct tu_cs sub_cs;
 
    /* Command streams to set pass index to a scratch reg */
@@ -406,6 +425,9 @@ struct tu_device
    VkCommandPool dynamic_rendering_pool;
    uint32_t dynamic_rendering_fence;
 
+   /* GMEM and tiling configs of recent dynamic render passes */
+   struct tu_dynamic_tiling_cache *dynamic_tiling_cache;
+
    /* Condition variable for timeline semaphore to notify waiters when a
     * new submit is executed. */
    pthread_cond_t timeline_cond;
@@ -418,6 +440,31 @@ struct tu_device
    struct tu_cs *dbg_cmdbuf_stomp_cs;
    struct tu_cs *dbg_renderpass_stomp_cs;
 
+   /* Binds after which a fast-linked pipeline gets recompiled with link-time
+    * optimization in the background, 0 if disabled.
+    */
+   uint32_t background_lto_binds;
+   uint32_t lto_swap_count;
+   int64_t lto_cycles_saved;
+
+   /* Pipeline cache and shader compile statistics, always accumulated and
+    * traced as counters, and logged with TU_DEBUG=cachestats.
+    */
+   struct {
+      uint32_t lookups;
+      uint32_t memory_hits;
+      uint32_t disk_hits;
+      uint32_t prewarm_hits;
+      uint32_t misses;
+      uint64_t compile_ns[MESA_SHADER_STAGES];
+      uint64_t upload_bytes;
+      int64_t last_dump_ns;
+   } cache_stats;
+
+   /* Draw state cache statistics, accumulated with TU_DEBUG=perf */
+   uint64_t dbg_draw_state_cache_hits;
+   uint64_t dbg_draw_state_cache_bytes_saved;
+
 #ifdef TU_HAS_VIRTIO
    struct tu_virtio_device *vdev;
 #endif
@@ -446,6 +493,11 @@ struct tu_device_memory
 
    struct tu_bo *bo;
 
+   /* Size accounted to the memory heap, which excludes the rounding up of
+    * allocations to BO cache buckets.
+    */
+   uint64_t heap_size;
+
    /* for dedicated allocations */
    struct tu_image *image;
 };
@@ -521,6 +573,26 @@ tu_device_lookup_bo(struct tu_device *device, uint32_t handle)
 struct u_trace_context *
 tu_device_get_u_trace(struct tu_device *device);
 
+/* Whether work that allocates host memory may be handed to the worker queue.
+ * Application allocators must only be called from the thread of the API
+ * call, so that's only allowed when neither the device nor the command uses
+ * one.
+ */
+extern thread_local bool tu_in_worker_queue_job;
+
+static inline bool
+tu_device_can_use_worker_queue(struct tu_device *device,
+                               const VkAllocationCallbacks *alloc)
+{
+   const VkAllocationCallbacks *default_alloc = vk_default_allocator();
+
+   /* A job waiting on jobs queued behind it could deadlock the queue. */
+   return !tu_in_worker_queue_job &&
+          util_queue_is_initialized(&device->worker_queue) &&
+          device->vk.alloc.pfnAllocation == default_alloc->pfnAllocation &&
+          (!alloc || alloc->pfnAllocation == default_alloc->pfnAllocation);
+}
+
 /* Get a scratch bo for use inside a command buffer. This will always return
  * the same bo given the same size or similar sizes, so only one scratch bo
  * can be used at the same time. It's meant for short-lived things where we
@@ -22,12 +22,72 @@
 
 #include "tu_cmd_buffer.h"
 #include "tu_cs.h"
+#include "tu_pass.h"
+
+#include "util/timespec.h"
 
 struct dynamic_rendering_entry {
    struct tu_cmd_buffer *cmd_buffer;
    uint32_t fence; /* The fence value when cmd_buffer becomes available */
 };
 
+/* Unlike VkFramebuffer, which has its tiling config computed once at
+ * creation, every CmdBeginRendering() sets up a new render pass and
+ * framebuffer. Applications tend to begin many passes with the same
+ * attachments and render area every frame, so the GMEM and tiling configs
+ * are looked up in a small LRU cache keyed by everything they depend on.
+ */
+#define DYNAMIC_TILING_CACHE_SIZE 16
+#define DYNAMIC_TILING_CACHE_MAX_ATTACHMENTS                                 \
+   (sizeof_field(struct tu_cmd_buffer, dynamic_rp_attachments) /             \
+    sizeof(struct tu_render_pass_attachment))
+
+struct dynamic_tiling_key {
+   uint32_t width;
+   uint32_t height;
+   uint32_t layers;
+   uint32_t num_views;
+   /* TU_DEBUG options affecting the tiling, which may change at runtime */
+   uint32_t debug;
+   uint32_t attachment_count;
+   struct {
+      VkFormat format;
+      VkSampleCountFlagBits samples;
+      uint32_t cpp;
+      bool gmem;
+      bool load;
+      bool store;
+      bool clear;
+      bool will_be_resolved;
+   } attachments[DYNAMIC_TILING_CACHE_MAX_ATTACHMENTS];
+};
+
+struct dynamic_tiling_entry {
+   struct dynamic_tiling_key key;
+   uint64_t hash;
+   /* 0 if the entry is empty */
+   uint64_t last_use;
+
+   uint32_t gmem_pixels[TU_GMEM_LAYOUT_COUNT];
+   uint32_t tile_align_w;
+   uint32_t min_cpp;
+   uint32_t gmem_bandwidth_per_pixel;
+   uint32_t sysmem_bandwidth_per_pixel;
+   struct {
+      int32_t gmem_offset[TU_GMEM_LAYOUT_COUNT];
+      int32_t gmem_offset_stencil[TU_GMEM_LAYOUT_COUNT];
+   } attachments[DYNAMIC_TILING_CACHE_MAX_ATTACHMENTS];
+   struct tu_tiling_config tiling[TU_GMEM_LAYOUT_COUNT];
+};
+
+struct tu_dynamic_tiling_cache {
+   mtx_t mutex;
+   uint64_t use_count;
+   uint32_t hits;
+   uint32_t misses;
+   struct dynamic_tiling_entry entries[DYNAMIC_TILING_CACHE_SIZE];
+};
+
 static VkResult
 get_cmd_buffer(struct tu_device *dev, struct tu_cmd_buffer **cmd_buffer_out)
 {
@@ -90,6 +150,13 @@ get_cmd_buffer(struct tu_device *dev, struct tu_cmd_buffer **cmd_buffer_out)
 VkResult
 tu_init_dynamic_rendering(struct tu_device *dev)
 {
+   dev->dynamic_tiling_cache = (struct tu_dynamic_tiling_cache *) vk_zalloc(
+      &dev->vk.alloc, sizeof(*dev->dynamic_tiling_cache), 8,
+      VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+   if (!dev->dynamic_tiling_cache)
+      return vk_error(dev, VK_ERROR_OUT_OF_HOST_MEMORY);
+   mtx_init(&dev->dynamic_tiling_cache->mutex, mtx_plain);
+
    util_dynarray_init(&dev->dynamic_rendering_pending, NULL);
    dev->dynamic_rendering_fence = 0;
 
@@ -100,18 +167,215 @@ tu_init_dynamic_rendering(struct tu_device *dev)
       .queueFamilyIndex = 0,
    };
 
-   return vk_common_CreateCommandPool(tu_device_to_handle(dev), &create_info,
-                                      &dev->vk.alloc,
-                                      &dev->dynamic_rendering_pool);
+   VkResult result =
+      tu_CreateCommandPool(tu_device_to_handle(dev), &create_info,
+                           &dev->vk.alloc, &dev->dynamic_rendering_pool);
+   if (result != VK_SUCCESS) {
+      mtx_destroy(&dev->dynamic_tiling_cache->mutex);
+      vk_free(&dev->vk.alloc, dev->dynamic_tiling_cache);
+   }
+
+   return result;
 }
 
 void
 tu_destroy_dynamic_rendering(struct tu_device *dev)
 {
-   vk_common_DestroyCommandPool(tu_device_to_handle(dev),
-                                dev->dynamic_rendering_pool,
-                                &dev->vk.alloc);
+   tu_DestroyCommandPool(tu_device_to_handle(dev),
+                         dev->dynamic_rendering_pool, &dev->vk.alloc);
    util_dynarray_fini(&dev->dynamic_rendering_pending);
+
+   mtx_destroy(&dev->dynamic_tiling_cache->mutex);
+   vk_free(&dev->vk.alloc, dev->dynamic_tiling_cache);
+}
+
+static bool
+dynamic_tiling_key_init(struct dynamic_tiling_key *key,
+                        const struct tu_render_pass *pass,
+                        const struct tu_framebuffer *fb)
+{
+   if (pass->attachment_count > DYNAMIC_TILING_CACHE_MAX_ATTACHMENTS)
+      return false;
+
+   /* Zero the padding, keys are hashed and compared as bytes. */
+   memset(key, 0, sizeof(*key));
+
+   key->width = fb->width;
+   key->height = fb->height;
+   key->layers = fb->layers;
+   key->num_views = pass->num_views;
+   key->debug = tu_env.debug & (TU_DEBUG_FORCEBIN | TU_DEBUG_NOBIN);
+   key->attachment_count = pass->attachment_count;
+
+   for (uint32_t i = 0; i < pass->attachment_count; i++) {
+      const struct tu_render_pass_attachment *att = &pass->attachments[i];
+      key->attachments[i].format = att->format;
+      key->attachments[i].samples = att->samples;
+      key->attachments[i].cpp = att->cpp;
+      key->attachments[i].gmem = att->gmem;
+      key->attachments[i].load = att->load;
+      key->attachments[i].store = att->store;
+      key->attachments[i].clear = att->clear_mask != 0;
+      key->attachments[i].will_be_resolved = att->will_be_resolved;
+   }
+
+   return true;
+}
+
+static void
+dynamic_tiling_entry_store(struct dynamic_tiling_entry *entry,
+                           const struct tu_render_pass *pass,
+                           const struct tu_framebuffer *fb)
+{
+   memcpy(entry->gmem_pixels, pass->gmem_pixels, sizeof(entry->gmem_pixels));
+   entry->tile_align_w = pass->tile_align_w;
+   entry->min_cpp = pass->min_cpp;
+   entry->gmem_bandwidth_per_pixel = pass->gmem_bandwidth_per_pixel;
+   entry->sysmem_bandwidth_per_pixel = pass->sysmem_bandwidth_per_pixel;
+
+   for (uint32_t i = 0; i < pass->attachment_count; i++) {
+      const struct tu_render_pass_attachment *att = &pass->attachments[i];
+      memcpy(entry->attachments[i].gmem_offset, att->gmem_offset,
+             sizeof(att->gmem_offset));
+      memcpy(entry->attachments[i].gmem_offset_stencil,
+             att->gmem_offset_stencil, sizeof(att->gmem_offset_stencil));
+   }
+
+   memcpy(entry->tiling, fb->tiling, sizeof(entry->tiling));
+}
+
+static void
+dynamic_tiling_entry_load(const struct dynamic_tiling_entry *entry,
+                          struct tu_render_pass *pass,
+                          struct tu_framebuffer *fb)
+{
+   memcpy(pass->gmem_pixels, entry->gmem_pixels, sizeof(pass->gmem_pixels));
+   pass->tile_align_w = entry->tile_align_w;
+   pass->min_cpp = entry->min_cpp;
+   pass->gmem_bandwidth_per_pixel = entry->gmem_bandwidth_per_pixel;
+   pass->sysmem_bandwidth_per_pixel = entry->sysmem_bandwidth_per_pixel;
+
+   for (uint32_t i = 0; i < pass->attachment_count; i++) {
+      struct tu_render_pass_attachment *att = &pass->attachments[i];
+      memcpy(att->gmem_offset, entry->attachments[i].gmem_offset,
+             sizeof(att->gmem_offset));
+      memcpy(att->gmem_offset_stencil,
+             entry->attachments[i].gmem_offset_stencil,
+             sizeof(att->gmem_offset_stencil));
+   }
+
+   memcpy(fb->tiling, entry->tiling, sizeof(fb->tiling));
+}
+
+static struct dynamic_tiling_entry *
+dynamic_tiling_cache_find(struct tu_dynamic_tiling_cache *cache,
+                          const struct dynamic_tiling_key *key,
+                          uint64_t hash)
+{
+   for (unsigned i = 0; i < DYNAMIC_TILING_CACHE_SIZE; i++) {
+      struct dynamic_tiling_entry *entry = &cache->entries[i];
+      if (entry->last_use && entry->hash == hash &&
+          memcmp(&entry->key, key, sizeof(*key)) == 0)
+         return entry;
+   }
+
+   return NULL;
+}
+
+/* Sets up the GMEM config of a dynamic render pass and the tiling config of
+ * its framebuffer, like tu_CreateRenderPass2() and tu_CreateFramebuffer() do
+ * for regular render passes.
+ */
+void
+tu_dynamic_tiling_config(struct tu_device *dev,
+                         struct tu_render_pass *pass,
+                         struct tu_framebuffer *fb)
+{
+   struct tu_dynamic_tiling_cache *cache = dev->dynamic_tiling_cache;
+   struct dynamic_tiling_key key;
+
+   if (!dynamic_tiling_key_init(&key, pass, fb)) {
+      tu_render_pass_gmem_config(pass, dev->physical_device);
+      tu_render_pass_bandwidth_config(pass);
+      tu_framebuffer_tiling_config(fb, dev, pass);
+      return;
+   }
+
+   uint64_t hash = XXH64(&key, sizeof(key), 0);
+
+   mtx_lock(&cache->mutex);
+   struct dynamic_tiling_entry *entry =
+      dynamic_tiling_cache_find(cache, &key, hash);
+   if (entry) {
+      entry->last_use = ++cache->use_count;
+      cache->hits++;
+      MESA_TRACE_SET_COUNTER("tu_dynamic_tiling_cache_hits", cache->hits);
+      dynamic_tiling_entry_load(entry, pass, fb);
+      mtx_unlock(&cache->mutex);
+      return;
+   }
+   cache->misses++;
+   MESA_TRACE_SET_COUNTER("tu_dynamic_tiling_cache_misses", cache->misses);
+   mtx_unlock(&cache->mutex);
+
+   /* Don't hold the lock while computing, other threads recording command
+    * buffers may hit in the meantime.
+    */
+   tu_render_pass_gmem_config(pass, dev->physical_device);
+   tu_render_pass_bandwidth_config(pass);
+   tu_framebuffer_tiling_config(fb, dev, pass);
+
+   mtx_lock(&cache->mutex);
+   /* Another thread may have added the same entry meanwhile. */
+   if (!dynamic_tiling_cache_find(cache, &key, hash)) {
+      entry = &cache->entries[0];
+      for (unsigned i = 1; i < DYNAMIC_TILING_CACHE_SIZE; i++) {
+         if (cache->entries[i].last_use < entry->last_use)
+            entry = &cache->entries[i];
+      }
+
+      entry->key = key;
+      entry->hash = hash;
+      entry->last_use = ++cache->use_count;
+      dynamic_tiling_entry_store(entry, pass, fb);
+   }
+   mtx_unlock(&cache->mutex);
+}
+
+void
+tu_dbg_log_dynamic_tiling_cache(struct tu_device *dev)
+{
+   static uint32_t last_hits = 0;
+   static uint32_t last_misses = 0;
+   static struct timespec last_time = {};
+
+   struct tu_dynamic_tiling_cache *cache = dev->dynamic_tiling_cache;
+
+   mtx_lock(&cache->mutex);
+
+   struct timespec current_time;
+   clock_gettime(CLOCK_MONOTONIC, &current_time);
+
+   if (timespec_sub_to_nsec(&current_time, &last_time) > 1000 * 1000 * 1000) {
+      last_time = current_time;
+   } else {
+      mtx_unlock(&cache->mutex);
+      return;
+   }
+
+   uint32_t hits = cache->hits - last_hits;
+   uint32_t misses = cache->misses - last_misses;
+
+   if (hits || misses) {
+      perf_debug(dev, "dynamic rendering tiling cache: %u hits, %u misses "
+                 "(%.1f%% hit rate)", hits, misses,
+                 100.0 * hits / (hits + misses));
+   }
+
+   last_hits = cache->hits;
+   last_misses = cache->misses;
+
+   mtx_unlock(&cache->mutex);
 }
 
 VkResult
@@ -16,6 +16,12 @@ VkResult tu_init_dynamic_rendering(struct tu_device *dev);
 
 void tu_destroy_dynamic_rendering(struct tu_device *dev);
 
+void tu_dynamic_tiling_config(struct tu_device *dev,
+                              struct tu_render_pass *pass,
+                              struct tu_framebuffer *fb);
+
+void tu_dbg_log_dynamic_tiling_cache(struct tu_device *dev);
+
 VkResult tu_insert_dynamic_cmdbufs(struct tu_device *dev,
                                    struct tu_cmd_buffer ***cmds_ptr,
                                    uint32_t *size);
@@ -0,0 +1,245 @@
+/*
+ * Copyright © 2025 Google LLC
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Prints the tile layouts picked by tu_framebuffer_tiling_config() for a
+ * matrix of framebuffer sizes and attachment sets, to check changes to the
+ * tile layout search without a device. Like gallium's gmemtool.
+ */
+
+#include <getopt.h>
+#include <inttypes.h>
+
+#include "tu_device.h"
+#include "tu_pass.h"
+#include "tu_util.h"
+
+struct attachment_set {
+   const char *name;
+   uint32_t count;
+   struct {
+      VkFormat format;
+      uint32_t cpp;
+      bool load, store;
+   } attachments[5];
+};
+
+/* clang-format off */
+static const struct attachment_set attachment_sets[] = {
+   { "rgba8", 1, {
+      { VK_FORMAT_R8G8B8A8_UNORM, 4, false, true },
+   } },
+   { "rgba8+d24s8", 2, {
+      { VK_FORMAT_R8G8B8A8_UNORM, 4, false, true },
+      { VK_FORMAT_D24_UNORM_S8_UINT, 4, false, false },
+   } },
+   { "rgba8(load)+d32s8", 2, {
+      { VK_FORMAT_R8G8B8A8_UNORM, 4, true, true },
+      { VK_FORMAT_D32_SFLOAT_S8_UINT, 4, false, false },
+   } },
+   { "rgba16f+d32", 2, {
+      { VK_FORMAT_R16G16B16A16_SFLOAT, 8, false, true },
+      { VK_FORMAT_D32_SFLOAT, 4, false, true },
+   } },
+   { "gbuffer 4xrgba8+d32", 5, {
+      { VK_FORMAT_R8G8B8A8_UNORM, 4, false, true },
+      { VK_FORMAT_R8G8B8A8_UNORM, 4, false, true },
+      { VK_FORMAT_R8G8B8A8_UNORM, 4, false, true },
+      { VK_FORMAT_R8G8B8A8_UNORM, 4, false, true },
+      { VK_FORMAT_D32_SFLOAT, 4, false, true },
+   } },
+};
+
+static const VkExtent2D sizes[] = {
+   { 1280, 720 },
+   { 1920, 1080 },
+   { 2400, 1080 },
+   { 2560, 1440 },
+   { 3840, 2160 },
+   { 810, 810 },
+   { 1024, 1024 },
+};
+/* clang-format on */
+
+/* GMEM sizes as reported by the kernel, see freedreno_noop.c */
+struct gpu_info {
+   const char *name;
+   uint32_t gpu_id;
+   uint64_t chip_id;
+   uint32_t gmem_size;
+};
+
+/* keep sorted by gpu name: */
+static const struct gpu_info gpu_infos[] = {
+   { "a618", 618, 0x060108ff, 512 * 1024 },
+   { "a630", 630, 0x060300ff, 1024 * 1024 },
+   { "a660", 660, 0x060600ff, 1024 * 1024 + 512 * 1024 },
+   { "a730", 730, 0x07030001, 2 * 1024 * 1024 },
+   { "a740", 740, 0x43050a01, 3 * 1024 * 1024 },
+   { "a750", 750, 0x43051401, 3 * 1024 * 1024 },
+};
+
+static const struct option opts[] = {
+   { .name = "gpu", .has_arg = 1, NULL, 'g' },
+   { .name = "layers", .has_arg = 1, NULL, 'l' },
+   { .name = "help", .has_arg = 0, NULL, 'h' },
+   {},
+};
+
+static void
+usage(void)
+{
+   fprintf(stderr, "Usage:\n\n"
+                   "\ttu_gmemtool [-h] [-g GPU] [-l LAYERS]\n\n"
+                   "Options:\n"
+                   "\t-g, --gpu=GPU       - use the GMEM configuration of the "
+                   "specified GPU\n"
+                   "\t-l, --layers=LAYERS - number of framebuffer layers\n"
+                   "\t-h, --help          - this usage message\n"
+                   "\n");
+   fprintf(stderr, "Where GPU is one of:\n");
+   for (int i = 0; i < ARRAY_SIZE(gpu_infos); i++)
+      fprintf(stderr, "\t%s\n", gpu_infos[i].name);
+   exit(2);
+}
+
+/* Mirrors the GMEM partitioning done by tu_physical_device_init(). */
+static void
+setup_gmem(struct tu_physical_device *phys_dev, uint32_t gmem_size)
+{
+   const struct fd_dev_info *info = phys_dev->info;
+   uint32_t color_cache_size_gmem =
+      info->num_ccu * info->a6xx.sysmem_per_ccu_color_cache_size /
+      (1 << info->a6xx.gmem_ccu_color_cache_fraction);
+
+   phys_dev->gmem_size = gmem_size;
+   if (info->a7xx.has_gmem_vpc_attr_buf) {
+      uint32_t vpc_attr_buf_offset_gmem =
+         gmem_size - info->a7xx.gmem_vpc_attr_buf_size * info->num_ccu;
+      phys_dev->ccu_offset_gmem =
+         vpc_attr_buf_offset_gmem - color_cache_size_gmem;
+      phys_dev->usable_gmem_size_gmem = vpc_attr_buf_offset_gmem;
+   } else {
+      phys_dev->ccu_offset_gmem = gmem_size - color_cache_size_gmem;
+      phys_dev->usable_gmem_size_gmem = gmem_size;
+   }
+}
+
+static struct tu_physical_device phys_dev;
+static struct tu_device dev;
+
+int
+main(int argc, char **argv)
+{
+   const char *gpu_name = "a660";
+   uint32_t layers = 1;
+   int c;
+
+   while ((c = getopt_long(argc, argv, "g:l:h", opts, NULL)) != -1) {
+      switch (c) {
+      case 'g':
+         gpu_name = optarg;
+         break;
+      case 'l':
+         layers = MAX2(atoi(optarg), 1);
+         break;
+      case 'h':
+      default:
+         usage();
+      }
+   }
+
+   const struct gpu_info *gpu_info = NULL;
+
+   for (int i = 0; i < ARRAY_SIZE(gpu_infos); i++) {
+      if (strcmp(gpu_name, gpu_infos[i].name) == 0) {
+         gpu_info = &gpu_infos[i];
+         break;
+      }
+   }
+
+   if (!gpu_info) {
+      printf("unrecognized gpu name: %s\n", gpu_name);
+      usage();
+   }
+
+   struct fd_dev_id dev_id = {
+      .gpu_id = gpu_info->gpu_id,
+      .chip_id = gpu_info->chip_id,
+   };
+
+   /* Honor TU_DEBUG=forcebin/nobin */
+   tu_env_init();
+
+   phys_dev.info = fd_dev_info_raw(&dev_id);
+   if (!phys_dev.info) {
+      printf("no device info for %s\n", gpu_name);
+      return 1;
+   }
+
+   setup_gmem(&phys_dev, gpu_info->gmem_size);
+   dev.physical_device = &phys_dev;
+
+   for (int i = 0; i < ARRAY_SIZE(attachment_sets); i++) {
+      const struct attachment_set *set = &attachment_sets[i];
+      struct tu_render_pass_attachment attachments[ARRAY_SIZE(set->attachments)] = {};
+      struct tu_render_pass pass = {};
+
+      for (uint32_t a = 0; a < set->count; a++) {
+         attachments[a].format = set->attachments[a].format;
+         attachments[a].samples = VK_SAMPLE_COUNT_1_BIT;
+         attachments[a].cpp = set->attachments[a].cpp;
+         attachments[a].load = set->attachments[a].load;
+         attachments[a].store = set->attachments[a].store;
+         attachments[a].gmem = true;
+      }
+
+      pass.attachment_count = set->count;
+      pass.attachments = attachments;
+      tu_render_pass_gmem_config(&pass, &phys_dev);
+      tu_render_pass_bandwidth_config(&pass);
+
+      printf("%s: %u bytes per pixel loaded/stored, tile_align_w=%u\n",
+             set->name, pass.gmem_bandwidth_per_pixel, pass.tile_align_w);
+
+      for (int s = 0; s < ARRAY_SIZE(sizes); s++) {
+         struct tu_framebuffer fb = {};
+         fb.width = sizes[s].width;
+         fb.height = sizes[s].height;
+         fb.layers = layers;
+
+         tu_framebuffer_tiling_config(&fb, &dev, &pass);
+
+         for (int l = 0; l < TU_GMEM_LAYOUT_COUNT; l++) {
+            const struct tu_tiling_config *tiling = &fb.tiling[l];
+            const char *layout =
+               l == TU_GMEM_LAYOUT_FULL ? "full" : "avoid-ccu";
+
+            if (!tiling->possible) {
+               printf("  %4ux%-4u %-9s: sysmem only\n", fb.width, fb.height,
+                      layout);
+               continue;
+            }
+
+            assert(tiling->tile0.width * tiling->tile_count.width >= fb.width);
+            assert(tiling->tile0.height * tiling->tile_count.height >= fb.height);
+            assert(tiling->tile0.width <= phys_dev.info->tile_max_w);
+            assert(tiling->tile0.height <= phys_dev.info->tile_max_h);
+
+            uint64_t cost = tu_tile_layout_cost(&fb, &dev, &pass,
+                                                tiling->tile_count, layers);
+            printf("  %4ux%-4u %-9s: %2ux%-2u bins of %4ux%-4u, "
+                   "%2ux%-2u pipes of %ux%u, %s, ~%" PRIu64 " KiB\n",
+                   fb.width, fb.height, layout, tiling->tile_count.width,
+                   tiling->tile_count.height, tiling->tile0.width,
+                   tiling->tile0.height, tiling->pipe_count.width,
+                   tiling->pipe_count.height, tiling->pipe0.width,
+                   tiling->pipe0.height,
+                   tiling->binning ? "binning" : "no binning", cost / 1024);
+         }
+      }
+   }
+
+   return 0;
+}
@@ -21,6 +21,8 @@
 #include "vk_debug_utils.h"
 
 #include "util/libdrm.h"
+#include "util/os_time.h"
+#include "util/u_debug.h"
 
 #include "tu_device.h"
 #include "tu_knl.h"
@@ -28,6 +30,265 @@
 #include "tu_rmv.h"
 
 
+/* Keep BOs in the cache for at least a second before reaping them. */
+#define TU_BO_CACHE_EXPIRE_NS (1000 * 1000 * 1000ull)
+/* Don't hold on to more than this many idle bytes. */
+#define TU_BO_CACHE_MAX_SIZE (256 * 1024 * 1024ull)
+
+static void
+tu_bo_cache_add_bucket(struct tu_bo_cache *cache, uint64_t size)
+{
+   assert(cache->num_buckets < ARRAY_SIZE(cache->buckets));
+
+   struct tu_bo_cache_bucket *bucket = &cache->buckets[cache->num_buckets++];
+   list_inithead(&bucket->list);
+   bucket->size = size;
+}
+
+void
+tu_bo_cache_init(struct tu_device *dev)
+{
+   struct tu_bo_cache *cache = &dev->bo_cache;
+
+   mtx_init(&cache->lock, mtx_plain);
+
+   /* Cached BOs would make the RMV trace lie about when memory is freed. */
+   cache->enabled = !debug_get_bool_option("TU_NO_BO_CACHE", false) &&
+                    !dev->vk.memory_trace_data.is_enabled;
+
+   /* Same bucket sizes as fd_bo_cache: a few page-sized buckets followed by
+    * powers of two with three more steps in between, up to 64MB.
+    */
+   tu_bo_cache_add_bucket(cache, os_page_size);
+   tu_bo_cache_add_bucket(cache, os_page_size * 2);
+   tu_bo_cache_add_bucket(cache, os_page_size * 3);
+
+   for (uint64_t size = 4 * os_page_size; size <= 64 * 1024 * 1024;
+        size *= 2) {
+      tu_bo_cache_add_bucket(cache, size);
+      tu_bo_cache_add_bucket(cache, size + size * 1 / 4);
+      tu_bo_cache_add_bucket(cache, size + size * 2 / 4);
+      tu_bo_cache_add_bucket(cache, size + size * 3 / 4);
+   }
+}
+
+/* Frees all BOs in the list, which must already be out of the cache. */
+static void
+tu_bo_cache_free_list(struct tu_device *dev, struct list_head *list)
+{
+   list_for_each_entry_safe (struct tu_bo, bo, list, cache_node) {
+      list_del(&bo->cache_node);
+      dev->instance->knl->bo_finish(dev, bo);
+   }
+}
+
+/* Moves BOs which have been idle for too long to the freelist.  Called with
+ * the cache lock held.
+ */
+static void
+tu_bo_cache_cleanup_locked(struct tu_bo_cache *cache, int64_t now,
+                           bool all, struct list_head *freelist)
+{
+   if (!all && now - cache->cleanup_time < TU_BO_CACHE_EXPIRE_NS)
+      return;
+
+   for (uint32_t i = 0; i < cache->num_buckets; i++) {
+      struct tu_bo_cache_bucket *bucket = &cache->buckets[i];
+
+      /* BOs are appended on free, so the oldest ones are at the head. */
+      list_for_each_entry_safe (struct tu_bo, bo, &bucket->list, cache_node) {
+         if (!all && now - bo->free_time < TU_BO_CACHE_EXPIRE_NS)
+            break;
+
+         list_del(&bo->cache_node);
+         list_addtail(&bo->cache_node, freelist);
+         bucket->count--;
+         bucket->expired++;
+         cache->cached_size -= bo->size;
+      }
+   }
+
+   cache->cleanup_time = now;
+}
+
+void
+tu_bo_cache_finish(struct tu_device *dev)
+{
+   struct tu_bo_cache *cache = &dev->bo_cache;
+   struct list_head freelist;
+   list_inithead(&freelist);
+
+   if (TU_DEBUG(STARTUP)) {
+      uint32_t hits = 0, misses = 0, expired = 0;
+      for (uint32_t i = 0; i < cache->num_buckets; i++) {
+         hits += cache->buckets[i].hits;
+         misses += cache->buckets[i].misses;
+         expired += cache->buckets[i].expired;
+      }
+      mesa_logi("BO cache: %u hits, %u misses, %u expired", hits, misses,
+                expired);
+   }
+
+   mtx_lock(&cache->lock);
+   tu_bo_cache_cleanup_locked(cache, os_time_get_nano(), true, &freelist);
+   mtx_unlock(&cache->lock);
+
+   tu_bo_cache_free_list(dev, &freelist);
+
+   mtx_destroy(&cache->lock);
+}
+
+static bool
+tu_bo_cache_is_recyclable(enum tu_bo_alloc_flags flags, uint64_t client_iova)
+{
+   return (flags & TU_BO_ALLOC_RECYCLABLE) && !client_iova &&
+          !(flags & (TU_BO_ALLOC_REPLAYABLE | TU_BO_ALLOC_DMABUF |
+                     TU_BO_ALLOC_SHAREABLE));
+}
+
+/* Returns the smallest bucket that can hold a BO of the given size. */
+static struct tu_bo_cache_bucket *
+tu_bo_cache_alloc_bucket(struct tu_bo_cache *cache, uint64_t size)
+{
+   for (uint32_t i = 0; i < cache->num_buckets; i++) {
+      if (cache->buckets[i].size >= size)
+         return &cache->buckets[i];
+   }
+
+   return NULL;
+}
+
+/* Returns the largest bucket whose size a BO of the given size satisfies, so
+ * that any BO found in a bucket is at least as big as the bucket size.
+ */
+static struct tu_bo_cache_bucket *
+tu_bo_cache_free_bucket(struct tu_bo_cache *cache, uint64_t size)
+{
+   struct tu_bo_cache_bucket *bucket = NULL;
+
+   for (uint32_t i = 0; i < cache->num_buckets; i++) {
+      if (cache->buckets[i].size > size)
+         break;
+      bucket = &cache->buckets[i];
+   }
+
+   /* Don't keep huge BOs which would only fit the last bucket. */
+   if (bucket && bucket == &cache->buckets[cache->num_buckets - 1] &&
+       size > bucket->size)
+      return NULL;
+
+   return bucket;
+}
+
+/* Tries to find an idle BO matching the allocation parameters.  On a miss
+ * the size is rounded up to the bucket size, so that the new BO lands back
+ * in the same bucket once freed.
+ */
+static struct tu_bo *
+tu_bo_cache_alloc(struct tu_device *dev, uint64_t *size,
+                  uint64_t client_iova, VkMemoryPropertyFlags mem_property,
+                  enum tu_bo_alloc_flags flags)
+{
+   struct tu_bo_cache *cache = &dev->bo_cache;
+
+   if (!cache->enabled || !tu_bo_cache_is_recyclable(flags, client_iova))
+      return NULL;
+
+   struct tu_bo_cache_bucket *bucket =
+      tu_bo_cache_alloc_bucket(cache, align64(*size, os_page_size));
+   if (!bucket)
+      return NULL;
+
+   *size = bucket->size;
+
+   struct tu_bo *bo = NULL;
+   struct list_head freelist;
+   list_inithead(&freelist);
+
+   mtx_lock(&cache->lock);
+
+   /* Prefer the most recently freed BO, it is the most likely to still be
+    * hot in the caches.
+    */
+   list_for_each_entry_rev (struct tu_bo, entry, &bucket->list, cache_node) {
+      if (entry->mem_property == mem_property && entry->alloc_flags == flags) {
+         bo = entry;
+         list_del(&bo->cache_node);
+         bucket->count--;
+         cache->cached_size -= bo->size;
+         break;
+      }
+   }
+
+   if (bo)
+      bucket->hits++;
+   else
+      bucket->misses++;
+
+   tu_bo_cache_cleanup_locked(cache, os_time_get_nano(), false, &freelist);
+
+   mtx_unlock(&cache->lock);
+
+   tu_bo_cache_free_list(dev, &freelist);
+
+   return bo;
+}
+
+/* Returns true if the cache took over the (last reference to the) BO. */
+static bool
+tu_bo_cache_free(struct tu_device *dev, struct tu_bo *bo)
+{
+   struct tu_bo_cache *cache = &dev->bo_cache;
+
+   if (!cache->enabled || !tu_bo_cache_is_recyclable(bo->alloc_flags, 0))
+      return false;
+
+   /* Since the BO can't be shared, nobody can grab a new reference to it
+    * behind our back once we hold the last one.
+    */
+   if (p_atomic_read(&bo->refcnt) != 1 || bo->implicit_sync ||
+       bo->never_unmap ||
+       bo->dump != !!(bo->alloc_flags & TU_BO_ALLOC_ALLOW_DUMP))
+      return false;
+
+   struct tu_bo_cache_bucket *bucket = tu_bo_cache_free_bucket(cache, bo->size);
+   if (!bucket)
+      return false;
+
+   /* The app may reuse the address range of a placed mapping as soon as the
+    * memory is freed, and whoever gets the BO next may want to map it at an
+    * address of their own, so never hand out a mapped BO.
+    */
+   tu_bo_unmap(dev, bo, false);
+
+   tu_debug_bos_del(dev, bo);
+   bo->name = NULL;
+
+   struct list_head freelist;
+   list_inithead(&freelist);
+
+   int64_t now = os_time_get_nano();
+   bool cached = false;
+
+   mtx_lock(&cache->lock);
+
+   tu_bo_cache_cleanup_locked(cache, now, false, &freelist);
+
+   if (cache->cached_size + bo->size <= TU_BO_CACHE_MAX_SIZE) {
+      bo->free_time = now;
+      list_addtail(&bo->cache_node, &bucket->list);
+      bucket->count++;
+      cache->cached_size += bo->size;
+      cached = true;
+   }
+
+   mtx_unlock(&cache->lock);
+
+   tu_bo_cache_free_list(dev, &freelist);
+
+   return cached;
+}
+
 VkResult
 tu_bo_init_new_explicit_iova(struct tu_device *dev,
                              struct vk_object_base *base,
@@ -39,11 +300,22 @@ tu_bo_init_new_explicit_iova(struct tu_device *dev,
 {
    struct tu_instance *instance = dev->physical_device->instance;
 
-   VkResult result =
-      dev->instance->knl->bo_init(dev, base, out_bo, size, client_iova,
-                                  mem_property, flags, name);
-   if (result != VK_SUCCESS)
-      return result;
+   struct tu_bo *bo =
+      tu_bo_cache_alloc(dev, &size, client_iova, mem_property, flags);
+   if (bo) {
+      bo->base = base;
+      bo->name = tu_debug_bos_add(dev, bo->size, name);
+      *out_bo = bo;
+   } else {
+      VkResult result =
+         dev->instance->knl->bo_init(dev, base, out_bo, size, client_iova,
+                                     mem_property, flags, name);
+      if (result != VK_SUCCESS)
+         return result;
+
+      (*out_bo)->mem_property = mem_property;
+      (*out_bo)->alloc_flags = flags;
+   }
 
    if ((mem_property & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) &&
        !(mem_property & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
@@ -94,6 +366,9 @@ tu_bo_finish(struct tu_device *dev, struct tu_bo *bo)
                              bo->iova, bo->size,
                              VK_DEVICE_ADDRESS_BINDING_TYPE_UNBIND_EXT);
 
+   if (tu_bo_cache_free(dev, bo))
+      return;
+
    dev->instance->knl->bo_finish(dev, bo);
 }
 
@@ -106,7 +381,11 @@ tu_bo_map(struct tu_device *dev, struct tu_bo *bo, void *placed_addr)
       /* The BO is already mapped, but with a different address. */
       return vk_errorf(dev, VK_ERROR_MEMORY_MAP_FAILED, "Cannot remap BO to a different address");
 
-   return dev->instance->knl->bo_map(dev, bo, placed_addr);
+   VkResult result = dev->instance->knl->bo_map(dev, bo, placed_addr);
+   if (result == VK_SUCCESS)
+      bo->placed_map = placed_addr != NULL;
+
+   return result;
 }
 
 VkResult
@@ -128,6 +407,7 @@ tu_bo_unmap(struct tu_device *dev, struct tu_bo *bo, bool reserve)
    }
 
    bo->map = NULL;
+   bo->placed_map = false;
 
    return VK_SUCCESS;
 }
@@ -299,6 +579,12 @@ tu_submit_finish(struct tu_device *dev, void *submit)
    return dev->instance->knl->submit_finish(dev, submit);
 }
 
+void
+tu_submit_reset(struct tu_device *dev, void *submit)
+{
+   return dev->instance->knl->submit_reset(dev, submit);
+}
+
 void
 tu_submit_add_entries(struct tu_device *dev, void *submit,
                       struct tu_cs_entry *entries,
@@ -23,6 +23,10 @@ enum tu_bo_alloc_flags {
    TU_BO_ALLOC_INTERNAL_RESOURCE = 1 << 3,
    TU_BO_ALLOC_DMABUF = 1 << 4,
    TU_BO_ALLOC_SHAREABLE = 1 << 5,
+   /* The BO doesn't need zero-initialized contents, so it may be served from
+    * and returned to the device's BO cache instead of the kernel.
+    */
+   TU_BO_ALLOC_RECYCLABLE = 1 << 6,
 };
 
 /* Define tu_timeline_sync type based on drm syncobj for a point type
@@ -71,9 +75,18 @@ struct tu_bo {
    bool implicit_sync : 1;
    bool never_unmap : 1;
    bool cached_non_coherent : 1;
+   bool placed_map : 1;
 
    bool dump;
 
+   /* Allocation parameters, used to match BOs in the BO cache. */
+   VkMemoryPropertyFlags mem_property;
+   enum tu_bo_alloc_flags alloc_flags;
+
+   /* Link in a tu_bo_cache_bucket and the time it was put there. */
+   struct list_head cache_node;
+   int64_t free_time;
+
    /* Pointer to the vk_object_base associated with the BO
     * for the purposes of VK_EXT_device_address_binding_report
     */
@@ -106,6 +119,7 @@ struct tu_knl {
                           void *metadata, uint32_t metadata_size);
    void *(*submit_create)(struct tu_device *device);
    void (*submit_finish)(struct tu_device *device, void *_submit);
+   void (*submit_reset)(struct tu_device *device, void *_submit);
    void (*submit_add_entries)(struct tu_device *device, void *_submit,
                               struct tu_cs_entry *entries,
                               unsigned num_entries);
@@ -119,6 +133,32 @@ struct tu_knl {
    const struct vk_device_entrypoint_table *device_entrypoints;
 };
 
+/* Size-bucketed cache of idle BOs, modelled after the gallium driver's
+ * fd_bo_cache.  Freed TU_BO_ALLOC_RECYCLABLE BOs are kept around (still
+ * mapped and with their iova) for a short while, so that apps churning
+ * through allocations of similar sizes don't pay for the GEM/kgsl ioctls,
+ * mmap and page faults on every allocation.
+ */
+struct tu_bo_cache_bucket {
+   uint64_t size;
+   uint32_t count;
+   uint32_t hits, misses, expired;
+   struct list_head list;
+};
+
+struct tu_bo_cache {
+   mtx_t lock;
+   bool enabled;
+
+   struct tu_bo_cache_bucket buckets[14 * 4];
+   uint32_t num_buckets;
+
+   /* Total size of the BOs currently sitting in the cache */
+   uint64_t cached_size;
+   /* Last time expired BOs were reaped */
+   int64_t cleanup_time;
+};
+
 struct tu_zombie_vma {
    int fence;
    uint32_t gem_handle;
@@ -161,6 +201,12 @@ tu_bo_init_new(struct tu_device *dev, struct vk_object_base *base,
       flags, name);
 }
 
+void
+tu_bo_cache_init(struct tu_device *dev);
+
+void
+tu_bo_cache_finish(struct tu_device *dev);
+
 VkResult
 tu_bo_init_dmabuf(struct tu_device *dev,
                   struct tu_bo **bo,
@@ -253,6 +299,9 @@ tu_submit_create(struct tu_device *dev);
 void
 tu_submit_finish(struct tu_device *dev, void *submit);
 
+void
+tu_submit_reset(struct tu_device *dev, void *submit);
+
 void
 tu_submit_add_entries(struct tu_device *dev, void *submit,
                       struct tu_cs_entry *entries,
@@ -149,6 +149,17 @@ msm_submit_finish(struct tu_device *device,
    vk_free(&device->vk.alloc, submit);
 }
 
+void
+msm_submit_reset(struct tu_device *device,
+                 void *_submit)
+{
+   struct tu_msm_queue_submit *submit =
+      (struct tu_msm_queue_submit *)_submit;
+
+   util_dynarray_clear(&submit->commands);
+   util_dynarray_clear(&submit->command_bos);
+}
+
 void
 msm_submit_add_entries(struct tu_device *device, void *_submit,
                        struct tu_cs_entry *entries, unsigned num_entries)
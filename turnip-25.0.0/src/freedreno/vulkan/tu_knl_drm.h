@@ -30,6 +30,7 @@ struct tu_msm_queue_submit
 
 void *msm_submit_create(struct tu_device *device);
 void msm_submit_finish(struct tu_device *device, void *_submit);
+void msm_submit_reset(struct tu_device *device, void *_submit);
 void msm_submit_add_entries(struct tu_device *device, void *_submit,
                             struct tu_cs_entry *entries,
                             unsigned num_entries);
@@ -982,6 +982,7 @@ static const struct tu_knl msm_knl_funcs = {
       .bo_get_metadata = msm_bo_get_metadata,
       .submit_create = msm_submit_create,
       .submit_finish = msm_submit_finish,
+      .submit_reset = msm_submit_reset,
       .submit_add_entries = msm_submit_add_entries,
       .queue_submit = msm_queue_submit,
       .queue_wait_fence = msm_queue_wait_fence,
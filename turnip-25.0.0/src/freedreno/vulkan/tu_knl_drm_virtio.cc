@@ -1104,6 +1104,7 @@ static const struct tu_knl virtio_knl_funcs = {
       .bo_finish = tu_drm_bo_finish,
       .submit_create = msm_submit_create,
       .submit_finish = msm_submit_finish,
+      .submit_reset = msm_submit_reset,
       .submit_add_entries = msm_submit_add_entries,
       .queue_submit = virtio_queue_submit,
       .queue_wait_fence = virtio_queue_wait_fence,
@@ -1033,6 +1033,367 @@ const struct vk_sync_type vk_kgsl_sync_type = {
    .export_sync_file = vk_kgsl_sync_export_sync_file,
 };
 
+/* Native timeline for kgsl: every signal operation records the kgsl_syncobj
+ * which signals that time point, so waits map directly onto kgsl timestamp
+ * waits instead of going through a binary vk_sync per time point. Time points
+ * are only created at submit time, so wait-before-signal relies on the
+ * runtime's WAIT_PENDING based submit thread.
+ *
+ * All state is protected by the device's submit_mutex, and timeline_cond is
+ * broadcast whenever new time points may be available.
+ */
+#define KGSL_TIMELINE_MAX_POINTS 64
+
+struct kgsl_timeline_point
+{
+   uint64_t value;
+   struct kgsl_syncobj syncobj;
+};
+
+struct vk_kgsl_timeline
+{
+   struct vk_sync vk;
+
+   /* Highest value known to be signaled */
+   uint64_t signaled_value;
+
+   /* Pending time points, sorted by value */
+   struct util_dynarray points;
+};
+
+static VkResult
+vk_kgsl_timeline_init(struct vk_device *device,
+                      struct vk_sync *sync,
+                      uint64_t initial_value)
+{
+   struct vk_kgsl_timeline *t =
+      container_of(sync, struct vk_kgsl_timeline, vk);
+   t->signaled_value = initial_value;
+   util_dynarray_init(&t->points, NULL);
+   return VK_SUCCESS;
+}
+
+static void
+vk_kgsl_timeline_finish(struct vk_device *device, struct vk_sync *sync)
+{
+   struct vk_kgsl_timeline *t =
+      container_of(sync, struct vk_kgsl_timeline, vk);
+   util_dynarray_foreach (&t->points, struct kgsl_timeline_point, point)
+      kgsl_syncobj_destroy(&point->syncobj);
+   util_dynarray_fini(&t->points);
+}
+
+/* Drops the time points which are known to be signaled. */
+static void
+kgsl_timeline_gc_locked(struct vk_kgsl_timeline *t)
+{
+   unsigned count =
+      util_dynarray_num_elements(&t->points, struct kgsl_timeline_point);
+   struct kgsl_timeline_point *points =
+      util_dynarray_element(&t->points, struct kgsl_timeline_point, 0);
+
+   unsigned done = 0;
+   while (done < count && points[done].value <= t->signaled_value) {
+      kgsl_syncobj_destroy(&points[done].syncobj);
+      done++;
+   }
+
+   if (done) {
+      memmove(points, points + done, (count - done) * sizeof(*points));
+      t->points.size -= done * sizeof(*points);
+   }
+}
+
+static void
+kgsl_timeline_set_signaled_locked(struct vk_kgsl_timeline *t, uint64_t value)
+{
+   if (value > t->signaled_value) {
+      t->signaled_value = value;
+      kgsl_timeline_gc_locked(t);
+   }
+}
+
+static bool
+kgsl_syncobj_is_signaled(struct tu_device *device,
+                         const struct kgsl_syncobj *s)
+{
+   switch (s->state) {
+   case KGSL_SYNCOBJ_STATE_SIGNALED:
+      return true;
+   case KGSL_SYNCOBJ_STATE_TS:
+      return wait_timestamp_safe(device->fd, s->queue->msm_queue_id,
+                                 s->timestamp, 0) == VK_SUCCESS;
+   case KGSL_SYNCOBJ_STATE_FD:
+      return sync_wait(s->fd, 0) == 0;
+   default:
+      return false;
+   }
+}
+
+/* Retires the oldest time points which have been reached. A timeline only
+ * used by the GPU never sees a host wait or get_value, so this is what keeps
+ * its time points from piling up.
+ */
+static void
+kgsl_timeline_retire_locked(struct tu_device *device,
+                            struct vk_kgsl_timeline *t)
+{
+   unsigned count =
+      util_dynarray_num_elements(&t->points, struct kgsl_timeline_point);
+   struct kgsl_timeline_point *points =
+      util_dynarray_element(&t->points, struct kgsl_timeline_point, 0);
+
+   unsigned done = 0;
+   while (done < count &&
+          kgsl_syncobj_is_signaled(device, &points[done].syncobj))
+      done++;
+
+   if (done)
+      kgsl_timeline_set_signaled_locked(t, points[done - 1].value);
+}
+
+/* Adds a time point signaled by syncobj, taking ownership of it. */
+static void
+kgsl_timeline_add_point_locked(struct tu_device *device,
+                               struct vk_kgsl_timeline *t, uint64_t value,
+                               struct kgsl_syncobj syncobj)
+{
+   if (syncobj.state == KGSL_SYNCOBJ_STATE_SIGNALED) {
+      kgsl_timeline_set_signaled_locked(t, value);
+      return;
+   }
+
+   kgsl_timeline_retire_locked(device, t);
+
+   /* Signal values must be increasing, drop anything this one supersedes. */
+   while (util_dynarray_num_elements(&t->points,
+                                     struct kgsl_timeline_point) > 0 &&
+          util_dynarray_top_ptr(&t->points, struct kgsl_timeline_point)->value >=
+             value) {
+      struct kgsl_timeline_point point =
+         util_dynarray_pop(&t->points, struct kgsl_timeline_point);
+      kgsl_syncobj_destroy(&point.syncobj);
+   }
+
+   /* Waits for a dropped time point are satisfied by the next one, which
+    * is only ever later, so drop the oldest one when there are too many.
+    */
+   if (util_dynarray_num_elements(&t->points, struct kgsl_timeline_point) >=
+       KGSL_TIMELINE_MAX_POINTS) {
+      struct kgsl_timeline_point *points =
+         util_dynarray_element(&t->points, struct kgsl_timeline_point, 0);
+      kgsl_syncobj_destroy(&points[0].syncobj);
+      memmove(points, points + 1,
+              (KGSL_TIMELINE_MAX_POINTS - 1) * sizeof(*points));
+      t->points.size -= sizeof(*points);
+   }
+
+   struct kgsl_timeline_point point = {
+      .value = value,
+      .syncobj = syncobj,
+   };
+   util_dynarray_append(&t->points, struct kgsl_timeline_point, point);
+}
+
+/* Returns the first time point which would satisfy a wait for value. */
+static struct kgsl_timeline_point *
+kgsl_timeline_find_point_locked(struct vk_kgsl_timeline *t, uint64_t value)
+{
+   unsigned count =
+      util_dynarray_num_elements(&t->points, struct kgsl_timeline_point);
+   struct kgsl_timeline_point *points =
+      util_dynarray_element(&t->points, struct kgsl_timeline_point, 0);
+
+   unsigned lo = 0, hi = count;
+   while (lo < hi) {
+      unsigned mid = lo + (hi - lo) / 2;
+      if (points[mid].value < value)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+
+   return lo < count ? &points[lo] : NULL;
+}
+
+static VkResult
+vk_kgsl_timeline_signal(struct vk_device *_device,
+                        struct vk_sync *sync,
+                        uint64_t value)
+{
+   struct tu_device *device = container_of(_device, struct tu_device, vk);
+   struct vk_kgsl_timeline *t =
+      container_of(sync, struct vk_kgsl_timeline, vk);
+
+   pthread_mutex_lock(&device->submit_mutex);
+   kgsl_timeline_set_signaled_locked(t, value);
+   pthread_mutex_unlock(&device->submit_mutex);
+
+   pthread_cond_broadcast(&device->timeline_cond);
+
+   return VK_SUCCESS;
+}
+
+static VkResult
+vk_kgsl_timeline_get_value(struct vk_device *_device,
+                           struct vk_sync *sync,
+                           uint64_t *value)
+{
+   struct tu_device *device = container_of(_device, struct tu_device, vk);
+   struct vk_kgsl_timeline *t =
+      container_of(sync, struct vk_kgsl_timeline, vk);
+
+   pthread_mutex_lock(&device->submit_mutex);
+
+   /* Find the latest time point which has been reached. */
+   unsigned count =
+      util_dynarray_num_elements(&t->points, struct kgsl_timeline_point);
+   struct kgsl_timeline_point *points =
+      util_dynarray_element(&t->points, struct kgsl_timeline_point, 0);
+   for (unsigned i = count; i-- > 0;) {
+      if (kgsl_syncobj_is_signaled(device, &points[i].syncobj)) {
+         kgsl_timeline_set_signaled_locked(t, points[i].value);
+         break;
+      }
+   }
+
+   *value = t->signaled_value;
+
+   pthread_mutex_unlock(&device->submit_mutex);
+
+   return VK_SUCCESS;
+}
+
+static VkResult
+vk_kgsl_timeline_wait(struct vk_device *_device,
+                      struct vk_sync *sync,
+                      uint64_t wait_value,
+                      enum vk_sync_wait_flags wait_flags,
+                      uint64_t abs_timeout_ns)
+{
+   struct tu_device *device = container_of(_device, struct tu_device, vk);
+   struct vk_kgsl_timeline *t =
+      container_of(sync, struct vk_kgsl_timeline, vk);
+
+   pthread_mutex_lock(&device->submit_mutex);
+
+   struct timespec abstime;
+   timespec_from_nsec(&abstime, abs_timeout_ns);
+
+   /* Wait for the time point to be submitted, like for an unsignaled
+    * kgsl_syncobj.
+    */
+   struct kgsl_timeline_point *point = NULL;
+   while (t->signaled_value < wait_value &&
+          !(point = kgsl_timeline_find_point_locked(t, wait_value))) {
+      int ret;
+      if (abs_timeout_ns == 0) {
+         ret = ETIMEDOUT;
+      } else if (abs_timeout_ns == UINT64_MAX) {
+         ret = pthread_cond_wait(&device->timeline_cond,
+                                 &device->submit_mutex);
+      } else {
+         ret = pthread_cond_timedwait(&device->timeline_cond,
+                                      &device->submit_mutex, &abstime);
+      }
+      if (ret != 0) {
+         assert(ret == ETIMEDOUT);
+         pthread_mutex_unlock(&device->submit_mutex);
+         return VK_TIMEOUT;
+      }
+   }
+
+   if (t->signaled_value >= wait_value ||
+       (wait_flags & VK_SYNC_WAIT_PENDING)) {
+      pthread_mutex_unlock(&device->submit_mutex);
+      return VK_SUCCESS;
+   }
+
+   /* The point may be dropped once we release the lock, wait on a copy. */
+   uint64_t point_value = point->value;
+   struct kgsl_syncobj syncobj = point->syncobj;
+   if (syncobj.state == KGSL_SYNCOBJ_STATE_FD) {
+      syncobj.fd = dup(syncobj.fd);
+      assert(syncobj.fd >= 0);
+   }
+
+   pthread_mutex_unlock(&device->submit_mutex);
+
+   VkResult result = kgsl_syncobj_wait(device, &syncobj, abs_timeout_ns);
+   kgsl_syncobj_destroy(&syncobj);
+
+   if (result == VK_SUCCESS) {
+      pthread_mutex_lock(&device->submit_mutex);
+      kgsl_timeline_set_signaled_locked(t, point_value);
+      pthread_mutex_unlock(&device->submit_mutex);
+   }
+
+   return result;
+}
+
+const struct vk_sync_type vk_kgsl_timeline_type = {
+   .size = sizeof(struct vk_kgsl_timeline),
+   .features = (enum vk_sync_features)
+               (VK_SYNC_FEATURE_TIMELINE |
+                VK_SYNC_FEATURE_GPU_WAIT |
+                VK_SYNC_FEATURE_CPU_WAIT |
+                VK_SYNC_FEATURE_CPU_SIGNAL |
+                VK_SYNC_FEATURE_WAIT_PENDING),
+   .init = vk_kgsl_timeline_init,
+   .finish = vk_kgsl_timeline_finish,
+   .signal = vk_kgsl_timeline_signal,
+   .get_value = vk_kgsl_timeline_get_value,
+   .wait = vk_kgsl_timeline_wait,
+};
+
+/* Returns the kgsl_syncobj a queue submission has to wait on. For timelines
+ * this is stored in *tmp, which is valid until submit_mutex is released.
+ */
+static const struct kgsl_syncobj *
+kgsl_sync_wait_syncobj(const struct vk_sync_wait *wait,
+                       struct kgsl_syncobj *tmp)
+{
+   if (wait->sync->type != &vk_kgsl_timeline_type)
+      return &container_of(wait->sync, struct vk_kgsl_syncobj, vk)->syncobj;
+
+   struct vk_kgsl_timeline *t =
+      container_of(wait->sync, struct vk_kgsl_timeline, vk);
+   struct kgsl_timeline_point *point =
+      kgsl_timeline_find_point_locked(t, wait->wait_value);
+
+   /* The runtime waits for all waits to be pending before submitting, so
+    * there is always a point unless the value was already reached.
+    */
+   kgsl_syncobj_init(tmp, t->signaled_value >= wait->wait_value);
+   if (tmp->state == KGSL_SYNCOBJ_STATE_UNSIGNALED && point)
+      *tmp = point->syncobj;
+
+   return tmp;
+}
+
+/* Makes a queue submission signal sync with the state of syncobj, taking
+ * ownership of it.
+ */
+static void
+kgsl_sync_signal(struct tu_device *device,
+                 const struct vk_sync_signal *signal,
+                 struct kgsl_syncobj syncobj)
+{
+   if (signal->sync->type == &vk_kgsl_timeline_type) {
+      struct vk_kgsl_timeline *t =
+         container_of(signal->sync, struct vk_kgsl_timeline, vk);
+      kgsl_timeline_add_point_locked(device, t, signal->signal_value,
+                                     syncobj);
+      return;
+   }
+
+   struct kgsl_syncobj *signal_sync =
+      &container_of(signal->sync, struct vk_kgsl_syncobj, vk)->syncobj;
+
+   kgsl_syncobj_reset(signal_sync);
+   *signal_sync = syncobj;
+}
+
 struct tu_kgsl_queue_submit {
    struct util_dynarray commands;
 };
@@ -1055,6 +1416,16 @@ kgsl_submit_finish(struct tu_device *device,
    vk_free(&device->vk.alloc, submit);
 }
 
+static void
+kgsl_submit_reset(struct tu_device *device,
+                  void *_submit)
+{
+   struct tu_kgsl_queue_submit *submit =
+      (struct tu_kgsl_queue_submit *)_submit;
+
+   util_dynarray_clear(&submit->commands);
+}
+
 static void
 kgsl_submit_add_entries(struct tu_device *device, void *_submit,
                         struct tu_cs_entry *entries, unsigned num_entries)
@@ -1091,10 +1462,10 @@ kgsl_queue_submit(struct tu_queue *queue, void *_submit,
 
    if (submit->commands.size == 0) {
       const struct kgsl_syncobj *wait_semaphores[wait_count + 1];
+      struct kgsl_syncobj timeline_waits[wait_count + 1];
       for (uint32_t i = 0; i < wait_count; i++) {
-         wait_semaphores[i] = &container_of(waits[i].sync,
-                                            struct vk_kgsl_syncobj, vk)
-                                  ->syncobj;
+         wait_semaphores[i] =
+            kgsl_sync_wait_syncobj(&waits[i], &timeline_waits[i]);
       }
 
       struct kgsl_syncobj last_submit_sync;
@@ -1117,14 +1488,16 @@ kgsl_queue_submit(struct tu_queue *queue, void *_submit,
              KGSL_SYNCOBJ_STATE_UNSIGNALED); // Would wait forever
 
       for (uint32_t i = 0; i < signal_count; i++) {
-         struct kgsl_syncobj *signal_sync =
-            &container_of(signals[i].sync, struct vk_kgsl_syncobj, vk)
-                ->syncobj;
-
-         kgsl_syncobj_reset(signal_sync);
-         *signal_sync = wait_sync;
+         struct kgsl_syncobj signal_sync = wait_sync;
+         if (signal_sync.state == KGSL_SYNCOBJ_STATE_FD) {
+            signal_sync.fd = dup(wait_sync.fd);
+            assert(signal_sync.fd >= 0);
+         }
+         kgsl_sync_signal(queue->device, &signals[i], signal_sync);
       }
 
+      kgsl_syncobj_destroy(&wait_sync);
+
       return VK_SUCCESS;
    }
 
@@ -1138,13 +1511,8 @@ kgsl_queue_submit(struct tu_queue *queue, void *_submit,
       mtx_unlock(&queue->device->kgsl_profiling_mutex);
    }
 
-   uint32_t obj_count = 0;
-   if (u_trace_submission_data)
-      obj_count++;
-
-   struct kgsl_command_object *objs = (struct kgsl_command_object *)
-      vk_alloc(&queue->device->vk.alloc, sizeof(*objs) * obj_count,
-               alignof(*objs), VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+   /* The profiling buffer is the only object we may pass. */
+   struct kgsl_command_object objs[1];
 
    struct kgsl_cmdbatch_profiling_buffer *profiling_buffer = NULL;
    uint32_t obj_idx = 0;
@@ -1164,10 +1532,10 @@ kgsl_queue_submit(struct tu_queue *queue, void *_submit,
    }
 
    const struct kgsl_syncobj *wait_semaphores[wait_count];
+   struct kgsl_syncobj timeline_waits[wait_count];
    for (uint32_t i = 0; i < wait_count; i++) {
       wait_semaphores[i] =
-         &container_of(waits[i].sync, struct vk_kgsl_syncobj, vk)
-             ->syncobj;
+         kgsl_sync_wait_syncobj(&waits[i], &timeline_waits[i]);
    }
 
    struct kgsl_syncobj wait_sync =
@@ -1279,14 +1647,13 @@ kgsl_queue_submit(struct tu_queue *queue, void *_submit,
    p_atomic_set(&queue->fence, req.timestamp);
 
    for (uint32_t i = 0; i < signal_count; i++) {
-      struct kgsl_syncobj *signal_sync =
-         &container_of(signals[i].sync, struct vk_kgsl_syncobj, vk)
-             ->syncobj;
-
-      kgsl_syncobj_reset(signal_sync);
-      signal_sync->state = KGSL_SYNCOBJ_STATE_TS;
-      signal_sync->queue = queue;
-      signal_sync->timestamp = req.timestamp;
+      struct kgsl_syncobj signal_sync = {
+         .state = KGSL_SYNCOBJ_STATE_TS,
+         .queue = queue,
+         .timestamp = req.timestamp,
+         .fd = -1,
+      };
+      kgsl_sync_signal(queue->device, &signals[i], signal_sync);
    }
 
    if (u_trace_submission_data) {
@@ -1377,6 +1744,7 @@ static const struct tu_knl kgsl_knl_funcs = {
       .bo_finish = kgsl_bo_finish,
       .submit_create = kgsl_submit_create,
       .submit_finish = kgsl_submit_finish,
+      .submit_reset = kgsl_submit_reset,
       .submit_add_entries = kgsl_submit_add_entries,
       .queue_submit = kgsl_queue_submit,
       .queue_wait_fence = kgsl_queue_wait_fence,
@@ -1473,10 +1841,13 @@ tu_knl_kgsl_load(struct tu_instance *instance, int fd)
 
    device->submitqueue_priority_count = 1;
    
-   device->timeline_type = vk_sync_timeline_get_type(&vk_kgsl_sync_type);
-
    device->sync_types[0] = &vk_kgsl_sync_type;
-   device->sync_types[1] = &device->timeline_type.sync;
+   if (debug_get_bool_option("TU_KGSL_EMULATED_TIMELINE", false)) {
+      device->timeline_type = vk_sync_timeline_get_type(&vk_kgsl_sync_type);
+      device->sync_types[1] = &device->timeline_type.sync;
+   } else {
+      device->sync_types[1] = &vk_kgsl_timeline_type;
+   }
    device->sync_types[2] = NULL;
 
    device->heap.size = tu_get_system_heap_size(device);
@@ -515,7 +515,7 @@ tu_render_pass_disable_fdm(struct tu_render_pass *pass)
    return false;
 }
 
-static void
+void
 tu_render_pass_calc_hash(struct tu_render_pass *pass)
 {
    #define HASH(hash, data) XXH64(&(data), sizeof(data), hash)
@@ -537,15 +537,8 @@ tu_render_pass_calc_hash(struct tu_render_pass *pass)
 }
 
 static void
-tu_render_pass_cond_config(struct tu_device *device,
-                           struct tu_render_pass *pass)
+tu_render_pass_cond_config(struct tu_render_pass *pass)
 {
-   /* With generic clears CmdClearAttachments isn't a draw and doesn't
-    * contribute to bin's geometry.
-    */
-   if (device->physical_device->info->a7xx.has_generic_clear)
-      return;
-
    for (uint32_t i = 0; i < pass->attachment_count; i++) {
       struct tu_render_pass_attachment *att = &pass->attachments[i];
 
@@ -553,7 +546,9 @@ tu_render_pass_cond_config(struct tu_device *device,
        * read/write the tile, we can skip load/store.
        *
        * The only other operations are clear and resolve, which disable
-       * conditional load/store.
+       * conditional load/store. CmdClearAttachments is emitted as a draw for
+       * these attachments, even with generic clears, so that it contributes
+       * to the bin's geometry.
        */
       att->cond_load_allowed =
          (att->load || att->load_stencil) && !att->clear_mask && !att->will_be_resolved;
@@ -565,7 +560,7 @@ tu_render_pass_cond_config(struct tu_device *device,
    }
 }
 
-static void
+void
 tu_render_pass_gmem_config(struct tu_render_pass *pass,
                            const struct tu_physical_device *phys_dev)
 {
@@ -669,7 +664,7 @@ tu_render_pass_gmem_config(struct tu_render_pass *pass,
    }
 }
 
-static void
+void
 tu_render_pass_bandwidth_config(struct tu_render_pass *pass)
 {
    pass->gmem_bandwidth_per_pixel = 0;
@@ -1028,7 +1023,7 @@ tu_CreateRenderPass2(VkDevice _device,
       }
    }
 
-   tu_render_pass_cond_config(device, pass);
+   tu_render_pass_cond_config(pass);
    tu_render_pass_gmem_config(pass, device->physical_device);
    tu_render_pass_bandwidth_config(pass);
    tu_render_pass_calc_views(pass);
@@ -1273,11 +1268,12 @@ tu_setup_dynamic_render_pass(struct tu_cmd_buffer *cmd_buffer,
 
    pass->attachment_count = a;
 
-   tu_render_pass_cond_config(device, pass);
-   tu_render_pass_gmem_config(pass, device->physical_device);
-   tu_render_pass_bandwidth_config(pass);
+   tu_render_pass_cond_config(pass);
    tu_render_pass_calc_views(pass);
-   tu_render_pass_calc_hash(pass);
+
+   /* The GMEM config and the autotune hash, which depends on it, are set up
+    * along with the framebuffer in tu_setup_dynamic_framebuffer().
+    */
 }
 
 void
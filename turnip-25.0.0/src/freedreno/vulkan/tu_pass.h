@@ -150,6 +150,13 @@ void tu_setup_dynamic_render_pass(struct tu_cmd_buffer *cmd_buffer,
 void tu_setup_dynamic_inheritance(struct tu_cmd_buffer *cmd_buffer,
                                   const VkCommandBufferInheritanceRenderingInfo *info);
 
+void tu_render_pass_calc_hash(struct tu_render_pass *pass);
+
+void tu_render_pass_gmem_config(struct tu_render_pass *pass,
+                                const struct tu_physical_device *phys_dev);
+
+void tu_render_pass_bandwidth_config(struct tu_render_pass *pass);
+
 uint32_t
 tu_subpass_get_attachment_to_resolve(const struct tu_subpass *subpass, uint32_t index);
 
@@ -1521,13 +1521,94 @@ tu_hash_compute(unsigned char *hash,
    _mesa_sha1_final(&ctx, hash);
 }
 
+void
+tu_pipeline_cache_stats_dump(struct tu_device *dev, bool force)
+{
+   int64_t now = os_time_get_nano();
+   int64_t last = p_atomic_read(&dev->cache_stats.last_dump_ns);
+
+   /* Log at most once a second while pipelines are being created. */
+   if (!force && (now - last < 1000000000ll ||
+                  p_atomic_cmpxchg(&dev->cache_stats.last_dump_ns, last,
+                                   now) != last))
+      return;
+
+   uint32_t lookups = p_atomic_read(&dev->cache_stats.lookups);
+   uint32_t memory_hits = p_atomic_read(&dev->cache_stats.memory_hits);
+   uint32_t disk_hits = p_atomic_read(&dev->cache_stats.disk_hits);
+   uint32_t prewarm_hits = p_atomic_read(&dev->cache_stats.prewarm_hits);
+   uint32_t misses = p_atomic_read(&dev->cache_stats.misses);
+
+   mesa_logi("pipeline cache: %u lookups, %u memory hits, %u disk hits, "
+             "%u prewarm hits, %u misses (%.1f%% hit rate)",
+             lookups, memory_hits, disk_hits, prewarm_hits, misses,
+             lookups ? 100.0 * (lookups - misses) / lookups : 0.0);
+
+   for (gl_shader_stage stage = MESA_SHADER_VERTEX;
+        stage < MESA_SHADER_STAGES; stage = (gl_shader_stage) (stage + 1)) {
+      uint64_t ns = p_atomic_read(&dev->cache_stats.compile_ns[stage]);
+      if (ns) {
+         mesa_logi("pipeline cache: %s compile time %.3f ms",
+                   _mesa_shader_stage_to_abbrev(stage), ns / 1000000.0);
+      }
+   }
+
+   mesa_logi("pipeline cache: %" PRIu64 " bytes uploaded to shader BOs",
+             p_atomic_read(&dev->cache_stats.upload_bytes));
+}
+
+/* Objects missing from the cache may have been compiled offline into the
+ * pre-warmed cache. They are added to the cache they were looked up in, so
+ * that they also end up in the application's cache data.
+ */
+static struct vk_pipeline_cache_object *
+tu_pipeline_cache_lookup_object(struct vk_pipeline_cache *cache,
+                                const void *key_data, size_t key_size,
+                                const struct vk_pipeline_cache_object_ops *ops,
+                                bool *application_cache_hit)
+{
+   struct tu_device *dev =
+      container_of(cache->base.device, struct tu_device, vk);
+   uint32_t *counter;
+   bool memory_hit;
+
+   struct vk_pipeline_cache_object *object =
+      vk_pipeline_cache_lookup_object(cache, key_data, key_size, ops,
+                                      &memory_hit);
+   if (object) {
+      counter = memory_hit ? &dev->cache_stats.memory_hits
+                           : &dev->cache_stats.disk_hits;
+   } else if (dev->prewarm_cache &&
+              (object = vk_pipeline_cache_lookup_object(
+                  dev->prewarm_cache, key_data, key_size, ops, NULL))) {
+      object = vk_pipeline_cache_add_object(cache, object);
+      counter = &dev->cache_stats.prewarm_hits;
+   } else {
+      counter = &dev->cache_stats.misses;
+   }
+
+   if (application_cache_hit)
+      *application_cache_hit = object && memory_hit;
+
+   UNUSED uint32_t lookups = p_atomic_inc_return(&dev->cache_stats.lookups);
+   UNUSED uint32_t count = p_atomic_inc_return(counter);
+   MESA_TRACE_SET_COUNTER("tu_pipeline_cache_lookups", lookups);
+   if (counter == &dev->cache_stats.misses)
+      MESA_TRACE_SET_COUNTER("tu_pipeline_cache_misses", count);
+
+   if (TU_DEBUG(CACHESTATS))
+      tu_pipeline_cache_stats_dump(dev, false);
+
+   return object;
+}
+
 static struct tu_shader *
 tu_pipeline_cache_lookup(struct vk_pipeline_cache *cache,
                          const void *key_data, size_t key_size,
                          bool *application_cache_hit)
 {
    struct vk_pipeline_cache_object *object =
-      vk_pipeline_cache_lookup_object(cache, key_data, key_size,
+      tu_pipeline_cache_lookup_object(cache, key_data, key_size,
                                       &tu_shader_ops, application_cache_hit);
    if (object)
       return container_of(object, struct tu_shader, base);
@@ -1641,8 +1722,9 @@ tu_nir_cache_lookup(struct vk_pipeline_cache *cache,
                     bool *application_cache_hit)
 {
    struct vk_pipeline_cache_object *object =
-      vk_pipeline_cache_lookup_object(cache, key_data, key_size,
-                                      &tu_nir_shaders_ops, application_cache_hit);
+      tu_pipeline_cache_lookup_object(cache, key_data, key_size,
+                                      &tu_nir_shaders_ops,
+                                      application_cache_hit);
    if (object)
       return container_of(object, struct tu_nir_shaders, base);
    else
@@ -2313,6 +2395,40 @@ tu_emit_program_state(struct tu_cs *sub_cs,
    prog->accesses_smask = fs->reads_smask || fs->writes_smask;
 }
 
+/* Shader objects are compiled without knowing the view mask, so the VS
+ * state is re-emitted with the view mask of the current render pass.
+ */
+template <chip CHIP>
+void
+tu_emit_shader_object_program_state(struct tu_cs *sub_cs,
+                                    struct tu_program_state *prog,
+                                    struct tu_shader **shaders,
+                                    uint32_t view_mask)
+{
+   tu_emit_program_state<CHIP>(sub_cs, prog, shaders);
+
+   if (!view_mask)
+      return;
+
+   const struct ir3_shader_variant *variants[MESA_SHADER_STAGES];
+   for (gl_shader_stage stage = MESA_SHADER_VERTEX;
+        stage < ARRAY_SIZE(variants); stage = (gl_shader_stage) (stage+1)) {
+      variants[stage] = shaders[stage] ? shaders[stage]->variant : NULL;
+   }
+
+   uint32_t safe_variants =
+      ir3_trim_constlen(variants, sub_cs->device->compiler);
+   bool has_gs = !!shaders[MESA_SHADER_GEOMETRY]->variant;
+
+   tu_emit_vs_view_mask<CHIP>(sub_cs, shaders[MESA_SHADER_VERTEX],
+                              safe_variants & (1u << MESA_SHADER_VERTEX),
+                              view_mask, &prog->vs_state,
+                              has_gs ? NULL : &prog->vs_binning_state);
+   if (has_gs)
+      prog->vs_binning_state = prog->vs_state;
+}
+TU_GENX(tu_emit_shader_object_program_state);
+
 static const enum mesa_vk_dynamic_graphics_state tu_vertex_input_state[] = {
    MESA_VK_DYNAMIC_VI,
 };
@@ -3746,10 +3862,9 @@ tu_emit_draw_state(struct tu_cmd_buffer *cmd)
        !(cmd->state.pipeline_draw_states & (1u << id))) {                     \
       unsigned size = tu6_##name##_size<CHIP>(cmd->device, __VA_ARGS__);      \
       if (size > 0) {                                                         \
-         tu_cs_begin_sub_stream(&cmd->sub_cs, size, &cs);                     \
+         tu_cmd_begin_draw_state(cmd, size, &cs);                             \
          tu6_emit_##name<CHIP>(&cs, __VA_ARGS__);                             \
-         cmd->state.dynamic_state[id] =                                       \
-            tu_cs_end_draw_state(&cmd->sub_cs, &cs);                          \
+         cmd->state.dynamic_state[id] = tu_cmd_end_draw_state(cmd, &cs);      \
       } else {                                                                \
          cmd->state.dynamic_state[id] = {};                                   \
       }                                                                       \
@@ -3767,19 +3882,12 @@ tu_emit_draw_state(struct tu_cmd_buffer *cmd)
       } else {                                                                \
          unsigned size = tu6_##name##_size<CHIP>(cmd->device, __VA_ARGS__);   \
          if (size > 0) {                                                      \
-            tu_cs_begin_sub_stream(&cmd->sub_cs, size, &cs);                  \
+            tu_cmd_begin_draw_state(cmd, size, &cs);                          \
             tu6_emit_##name<CHIP>(&cs, __VA_ARGS__);                          \
-            cmd->state.dynamic_state[id] =                                    \
-               tu_cs_end_draw_state(&cmd->sub_cs, &cs);                       \
+            cmd->state.dynamic_state[id] = tu_cmd_end_draw_state(cmd, &cs);   \
          } else {                                                             \
             cmd->state.dynamic_state[id] = {};                                \
          }                                                                    \
-         tu_cs_begin_sub_stream(&cmd->sub_cs,                                 \
-                                tu6_##name##_size<CHIP>(cmd->device, __VA_ARGS__),  \
-                                &cs);                                         \
-         tu6_emit_##name<CHIP>(&cs, __VA_ARGS__);                             \
-         cmd->state.dynamic_state[id] =                                       \
-            tu_cs_end_draw_state(&cmd->sub_cs, &cs);                          \
       }                                                                       \
       dirty_draw_states |= (1u << id);                                        \
    }
@@ -3983,6 +4091,281 @@ tu_pipeline_builder_parse_rasterization_order(
                         A6XX_GRAS_SC_CNTL_SINGLE_PRIM_MODE(gmem_prim_mode));
 }
 
+/* Rough per-invocation cycle count of a program, from the ir3 stats. */
+static int32_t
+tu_program_cycle_estimate(struct tu_shader *const *shaders)
+{
+   int32_t cycles = 0;
+
+   for (unsigned i = 0; i < MESA_SHADER_STAGES; i++) {
+      if (!shaders[i] || !shaders[i]->variant)
+         continue;
+
+      const struct ir3_info *info = &shaders[i]->variant->info;
+      cycles += info->instrs_count + info->sstall + info->systall;
+   }
+
+   return cycles;
+}
+
+/* Set up background link-time optimization for a pipeline that was
+ * fast-linked from separately compiled libraries which retained their NIR.
+ */
+static void
+tu_pipeline_builder_init_lto(struct tu_pipeline_builder *builder,
+                             struct tu_graphics_pipeline *gfx_pipeline)
+{
+   struct tu_device *dev = builder->device;
+   struct tu_pipeline *pipeline = &gfx_pipeline->base;
+
+   if (!dev->background_lto_binds || builder->num_libraries < 2 ||
+       builder->active_stages ||
+       (builder->create_flags &
+        VK_PIPELINE_CREATE_2_LINK_TIME_OPTIMIZATION_BIT_EXT) ||
+       !util_queue_is_initialized(&dev->worker_queue))
+      return;
+
+   /* The patch control points state is baked from the shader variants, so
+    * it would have to be re-emitted along with the program.
+    */
+   if (pipeline->active_stages &
+       (VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT |
+        VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT))
+      return;
+
+   struct tu_nir_shaders *nir_shaders[MESA_SHADER_FRAGMENT + 1] = {};
+   for (unsigned i = 0; i < builder->num_libraries; i++) {
+      struct tu_graphics_lib_pipeline *library = builder->libraries[i];
+
+      /* The stages were already compiled together. */
+      if (contains_all_shader_state(library->state))
+         return;
+
+      for (gl_shader_stage stage = MESA_SHADER_VERTEX;
+           stage < ARRAY_SIZE(library->shaders);
+           stage = (gl_shader_stage) (stage + 1)) {
+         if (!(library->base.active_stages & mesa_to_vk_shader_stage(stage)))
+            continue;
+
+         /* We can only keep NIR alive that the library owns itself, not NIR
+          * it borrowed from its own libraries.
+          */
+         if (!library->nir_shaders || !library->shaders[stage].nir ||
+             library->nir_shaders->nir[stage] != library->shaders[stage].nir)
+            return;
+
+         nir_shaders[stage] = library->nir_shaders;
+      }
+   }
+
+   for (gl_shader_stage stage = MESA_SHADER_VERTEX;
+        stage < ARRAY_SIZE(nir_shaders); stage = (gl_shader_stage) (stage + 1)) {
+      if ((pipeline->active_stages & mesa_to_vk_shader_stage(stage)) &&
+          !nir_shaders[stage])
+         return;
+   }
+
+   struct tu_pipeline_lto *lto = (struct tu_pipeline_lto *) vk_zalloc(
+      &dev->vk.alloc, sizeof(*lto), 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   if (!lto)
+      return;
+
+   lto->device = dev;
+   lto->pipeline = pipeline;
+   lto->flags = builder->create_flags |
+                VK_PIPELINE_CREATE_2_LINK_TIME_OPTIMIZATION_BIT_EXT;
+   lto->state = builder->state;
+
+   lto->layout = builder->layout;
+   for (unsigned i = 0; i < lto->layout.num_sets; i++) {
+      if (lto->layout.set[i].layout)
+         vk_descriptor_set_layout_ref(&lto->layout.set[i].layout->vk);
+   }
+
+   for (gl_shader_stage stage = MESA_SHADER_VERTEX;
+        stage < ARRAY_SIZE(nir_shaders); stage = (gl_shader_stage) (stage + 1)) {
+      if (!nir_shaders[stage])
+         continue;
+
+      vk_pipeline_cache_object_ref(&nir_shaders[stage]->base);
+      lto->nir_shaders[stage] = nir_shaders[stage];
+      lto->nir[stage] = nir_shaders[stage]->nir[stage];
+
+      for (unsigned i = 0; i < builder->num_libraries; i++) {
+         if (builder->libraries[i]->nir_shaders == nir_shaders[stage])
+            lto->keys[stage] = builder->libraries[i]->shaders[stage].key;
+      }
+   }
+
+   util_queue_fence_init(&lto->fence);
+   gfx_pipeline->lto = lto;
+}
+
+template <chip CHIP>
+static void
+tu_pipeline_lto_compile(void *job, void *gdata, int thread_index)
+{
+   struct tu_pipeline_lto *lto = (struct tu_pipeline_lto *) job;
+   struct tu_device *dev = lto->device;
+   struct tu_pipeline *pipeline = lto->pipeline;
+
+   MESA_TRACE_FUNC();
+
+   const VkPipelineShaderStageCreateInfo *stage_infos[MESA_SHADER_STAGES] = {};
+   nir_shader *nir[MESA_SHADER_STAGES] = {};
+   struct tu_shader_key keys[MESA_SHADER_STAGES] = {};
+   struct tu_shader *shaders[MESA_SHADER_STAGES] = {};
+   VkPipelineCreationFeedback stage_feedbacks[MESA_SHADER_STAGES] = {};
+   void *mem_ctx = ralloc_context(NULL);
+
+   for (gl_shader_stage stage = MESA_SHADER_VERTEX;
+        stage < ARRAY_SIZE(lto->nir); stage = (gl_shader_stage) (stage + 1)) {
+      if (!lto->nir[stage])
+         continue;
+
+      nir[stage] = nir_shader_clone(mem_ctx, lto->nir[stage]);
+      keys[stage] = lto->keys[stage];
+   }
+
+   /* This hashes the same way as a pipeline created from the same libraries
+    * with LINK_TIME_OPTIMIZATION, so the two share their shaders.
+    */
+   unsigned char pipeline_sha1[20];
+   tu_hash_shaders(pipeline_sha1, lto->flags, stage_infos, nir, &lto->layout,
+                   keys, lto->state);
+
+   unsigned char shader_sha1[21];
+   memcpy(shader_sha1, pipeline_sha1, sizeof(pipeline_sha1));
+
+   bool cache_hit = true;
+   for (gl_shader_stage stage = MESA_SHADER_VERTEX; stage < ARRAY_SIZE(nir);
+        stage = (gl_shader_stage) (stage + 1)) {
+      if (!nir[stage])
+         continue;
+
+      bool application_cache_hit;
+      shader_sha1[20] = (unsigned char) stage;
+      shaders[stage] =
+         tu_pipeline_cache_lookup(dev->mem_cache, &shader_sha1,
+                                  sizeof(shader_sha1), &application_cache_hit);
+      if (!shaders[stage]) {
+         cache_hit = false;
+         break;
+      }
+   }
+
+   if (!cache_hit) {
+      for (gl_shader_stage stage = MESA_SHADER_VERTEX; stage < ARRAY_SIZE(nir);
+           stage = (gl_shader_stage) (stage + 1)) {
+         if (shaders[stage]) {
+            vk_pipeline_cache_object_unref(&dev->vk, &shaders[stage]->base);
+            shaders[stage] = NULL;
+         }
+      }
+
+      /* Keep the stages of this job on this thread, see
+       * tu_device_can_use_worker_queue().
+       */
+      tu_in_worker_queue_job = true;
+      VkResult result =
+         tu_compile_shaders(dev, lto->flags, stage_infos, nir, keys,
+                            &lto->layout, pipeline_sha1, shaders, NULL, NULL,
+                            NULL, stage_feedbacks);
+      tu_in_worker_queue_job = false;
+
+      if (result != VK_SUCCESS) {
+         ralloc_free(mem_ctx);
+         return;
+      }
+
+      for (gl_shader_stage stage = MESA_SHADER_VERTEX; stage < ARRAY_SIZE(nir);
+           stage = (gl_shader_stage) (stage + 1)) {
+         if (shaders[stage])
+            shaders[stage] = tu_pipeline_cache_insert(dev->mem_cache,
+                                                      shaders[stage]);
+      }
+   }
+
+   ralloc_free(mem_ctx);
+
+   /* Stages without NIR, like the empty ones, stay as they were. */
+   for (gl_shader_stage stage = MESA_SHADER_VERTEX;
+        stage < ARRAY_SIZE(shaders); stage = (gl_shader_stage) (stage + 1)) {
+      if (!shaders[stage] && pipeline->shaders[stage]) {
+         shaders[stage] = pipeline->shaders[stage];
+         vk_pipeline_cache_object_ref(&shaders[stage]->base);
+      }
+   }
+
+   tu_cs_init(&lto->cs, dev, TU_CS_MODE_SUB_STREAM, 512, "lto program");
+   tu_emit_program_state<CHIP>(&lto->cs, &lto->program, shaders);
+   memcpy(lto->shaders, shaders, sizeof(shaders));
+
+   int32_t cycles_saved = tu_program_cycle_estimate(pipeline->shaders) -
+                          tu_program_cycle_estimate(shaders);
+   UNUSED uint32_t swap_count = p_atomic_inc_return(&dev->lto_swap_count);
+   UNUSED int64_t total_cycles_saved =
+      p_atomic_add_return(&dev->lto_cycles_saved, cycles_saved);
+   MESA_TRACE_SET_COUNTER("tu_lto_swaps", swap_count);
+   MESA_TRACE_SET_COUNTER("tu_lto_cycles_saved", total_cycles_saved);
+   perf_debug(dev,
+              "swapping in link-time optimized program for pipeline %p, "
+              "estimated %d cycles saved per invocation",
+              pipeline, cycles_saved);
+
+   p_atomic_set(&lto->ready, true);
+}
+
+/* Count a bind of a fast-linked pipeline, queueing its link-time optimized
+ * recompile once it is hot, and return the optimized program once ready.
+ */
+const struct tu_pipeline_lto *
+tu_pipeline_lto_bind(struct tu_device *dev,
+                     struct tu_graphics_pipeline *pipeline)
+{
+   struct tu_pipeline_lto *lto = pipeline->lto;
+
+   if (p_atomic_read(&lto->ready))
+      return lto;
+
+   if (p_atomic_read(&lto->bind_count) < dev->background_lto_binds &&
+       p_atomic_inc_return(&lto->bind_count) == dev->background_lto_binds &&
+       tu_device_can_use_worker_queue(dev, NULL)) {
+      util_queue_add_job(&dev->worker_queue, lto, &lto->fence,
+                         TU_CALLX(dev, tu_pipeline_lto_compile), NULL, 0);
+   }
+
+   return NULL;
+}
+
+static void
+tu_pipeline_lto_finish(struct tu_device *dev, struct tu_pipeline_lto *lto)
+{
+   util_queue_fence_wait(&lto->fence);
+   util_queue_fence_destroy(&lto->fence);
+
+   if (lto->ready) {
+      tu_cs_finish(&lto->cs);
+      for (unsigned i = 0; i < ARRAY_SIZE(lto->shaders); i++) {
+         if (lto->shaders[i])
+            vk_pipeline_cache_object_unref(&dev->vk, &lto->shaders[i]->base);
+      }
+   }
+
+   for (unsigned i = 0; i < ARRAY_SIZE(lto->nir_shaders); i++) {
+      if (lto->nir_shaders[i])
+         vk_pipeline_cache_object_unref(&dev->vk, &lto->nir_shaders[i]->base);
+   }
+
+   for (unsigned i = 0; i < lto->layout.num_sets; i++) {
+      if (lto->layout.set[i].layout)
+         vk_descriptor_set_layout_unref(&dev->vk,
+                                        &lto->layout.set[i].layout->vk);
+   }
+
+   vk_free(&dev->vk.alloc, lto);
+}
+
 static void
 tu_pipeline_finish(struct tu_pipeline *pipeline,
                    struct tu_device *dev,
@@ -4009,6 +4392,12 @@ tu_pipeline_finish(struct tu_pipeline *pipeline,
       }
 
       vk_free2(&dev->vk.alloc, alloc, library->state_data);
+   } else if (pipeline->type == TU_PIPELINE_GRAPHICS) {
+      struct tu_graphics_pipeline *gfx_pipeline =
+         tu_pipeline_to_graphics(pipeline);
+
+      if (gfx_pipeline->lto)
+         tu_pipeline_lto_finish(dev, gfx_pipeline->lto);
    }
 
    for (unsigned i = 0; i < ARRAY_SIZE(pipeline->shaders); i++) {
@@ -4161,6 +4550,8 @@ tu_pipeline_builder_build(struct tu_pipeline_builder *builder,
          vk_pipeline_flags_feedback_loops(builder->graphics_state.pipeline_flags);
       gfx_pipeline->feedback_loop_may_involve_textures =
          builder->graphics_state.feedback_loop_not_input_only;
+
+      tu_pipeline_builder_init_lto(builder, gfx_pipeline);
    }
 
    return VK_SUCCESS;
@@ -4388,6 +4779,143 @@ tu_graphics_pipeline_create(VkDevice device,
    return result;
 }
 
+template <chip CHIP>
+static VkResult
+tu_compute_pipeline_create(VkDevice device,
+                           VkPipelineCache pipelineCache,
+                           const VkComputePipelineCreateInfo *pCreateInfo,
+                           VkPipelineCreateFlags2KHR flags,
+                           const VkAllocationCallbacks *pAllocator,
+                           VkPipeline *pPipeline);
+
+#define TU_PIPELINE_BATCH_MAX_JOBS 16
+
+/* A vkCreate*Pipelines call whose pipelines are created by several threads,
+ * each taking the next pipeline off the shared counter until none are left.
+ */
+struct tu_pipeline_batch {
+   VkDevice device;
+   VkPipelineCache cache;
+   const VkGraphicsPipelineCreateInfo *graphics_infos;
+   const VkComputePipelineCreateInfo *compute_infos;
+   const VkAllocationCallbacks *alloc;
+   VkPipeline *pipelines;
+   uint32_t count;
+
+   uint32_t next;
+   /* Index of the first failing pipeline in the upper 32 bits and its
+    * VkResult in the lower ones, so that the lowest index wins no matter
+    * which thread fails first. UINT64_MAX if every pipeline was created.
+    */
+   uint64_t failure;
+};
+
+struct tu_pipeline_batch_job {
+   struct tu_pipeline_batch *batch;
+   struct util_queue_fence fence;
+};
+
+template <chip CHIP>
+static void
+tu_pipeline_batch_run(struct tu_pipeline_batch *batch)
+{
+   uint32_t i;
+   while ((i = p_atomic_inc_return(&batch->next) - 1) < batch->count) {
+      VkResult result;
+      if (batch->graphics_infos) {
+         const VkGraphicsPipelineCreateInfo *info = &batch->graphics_infos[i];
+         result = tu_graphics_pipeline_create<CHIP>(
+            batch->device, batch->cache, info,
+            vk_graphics_pipeline_create_flags(info), batch->alloc,
+            &batch->pipelines[i]);
+      } else {
+         const VkComputePipelineCreateInfo *info = &batch->compute_infos[i];
+         result = tu_compute_pipeline_create<CHIP>(
+            batch->device, batch->cache, info,
+            vk_compute_pipeline_create_flags(info), batch->alloc,
+            &batch->pipelines[i]);
+      }
+
+      if (result != VK_SUCCESS) {
+         batch->pipelines[i] = VK_NULL_HANDLE;
+
+         uint64_t failure = (uint64_t) i << 32 | (uint32_t) result;
+         uint64_t old = p_atomic_read(&batch->failure);
+         while (failure < old) {
+            uint64_t prev = p_atomic_cmpxchg(&batch->failure, old, failure);
+            if (prev == old)
+               break;
+            old = prev;
+         }
+      }
+   }
+}
+
+template <chip CHIP>
+static void
+tu_pipeline_batch_job_execute(void *job, void *gdata, int thread_index)
+{
+   tu_in_worker_queue_job = true;
+   tu_pipeline_batch_run<CHIP>(((struct tu_pipeline_batch_job *) job)->batch);
+   tu_in_worker_queue_job = false;
+}
+
+/* Create the pipelines of \a batch on the calling thread and the worker
+ * queue, returning false if they have to be created serially instead.
+ */
+template <chip CHIP>
+static bool
+tu_create_pipeline_batch(struct tu_device *dev,
+                         struct tu_pipeline_batch *batch,
+                         VkResult *result)
+{
+   VK_FROM_HANDLE(vk_pipeline_cache, cache, batch->cache);
+
+   if (batch->count < 2 ||
+       !tu_device_can_use_worker_queue(dev, batch->alloc))
+      return false;
+
+   if (cache &&
+       (cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT))
+      return false;
+
+   /* Early return has to skip every pipeline after the first failure, which
+    * only makes sense when they are created in order.
+    */
+   for (uint32_t i = 0; i < batch->count; i++) {
+      VkPipelineCreateFlags2KHR flags = batch->graphics_infos ?
+         vk_graphics_pipeline_create_flags(&batch->graphics_infos[i]) :
+         vk_compute_pipeline_create_flags(&batch->compute_infos[i]);
+      if (flags & VK_PIPELINE_CREATE_2_EARLY_RETURN_ON_FAILURE_BIT_KHR)
+         return false;
+   }
+
+   struct tu_pipeline_batch_job jobs[TU_PIPELINE_BATCH_MAX_JOBS];
+   unsigned num_jobs = MIN3(batch->count - 1, dev->worker_queue.max_threads,
+                            TU_PIPELINE_BATCH_MAX_JOBS);
+
+   batch->next = 0;
+   batch->failure = UINT64_MAX;
+
+   for (unsigned i = 0; i < num_jobs; i++) {
+      jobs[i].batch = batch;
+      util_queue_fence_init(&jobs[i].fence);
+      util_queue_add_job(&dev->worker_queue, &jobs[i], &jobs[i].fence,
+                         tu_pipeline_batch_job_execute<CHIP>, NULL, 0);
+   }
+
+   tu_pipeline_batch_run<CHIP>(batch);
+
+   for (unsigned i = 0; i < num_jobs; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+
+   *result = batch->failure == UINT64_MAX ?
+      VK_SUCCESS : (VkResult) (int32_t) (uint32_t) batch->failure;
+   return true;
+}
+
 template <chip CHIP>
 VKAPI_ATTR VkResult VKAPI_CALL
 tu_CreateGraphicsPipelines(VkDevice device,
@@ -4398,9 +4926,21 @@ tu_CreateGraphicsPipelines(VkDevice device,
                            VkPipeline *pPipelines)
 {
    MESA_TRACE_FUNC();
+   VK_FROM_HANDLE(tu_device, dev, device);
    VkResult final_result = VK_SUCCESS;
    uint32_t i = 0;
 
+   struct tu_pipeline_batch batch = {
+      .device = device,
+      .cache = pipelineCache,
+      .graphics_infos = pCreateInfos,
+      .alloc = pAllocator,
+      .pipelines = pPipelines,
+      .count = count,
+   };
+   if (tu_create_pipeline_batch<CHIP>(dev, &batch, &final_result))
+      return final_result;
+
    for (; i < count; i++) {
       VkPipelineCreateFlags2KHR flags =
          vk_graphics_pipeline_create_flags(&pCreateInfos[i]);
@@ -4520,6 +5060,7 @@ tu_compute_pipeline_create(VkDevice device,
       }
 
       struct ir3_shader_key ir3_key = {};
+      int64_t compile_start = os_time_get_nano();
 
       nir_shader *nir = tu_spirv_to_nir(dev, pipeline_mem_ctx, flags,
                                         stage_info, &key, MESA_SHADER_COMPUTE);
@@ -4534,6 +5075,9 @@ tu_compute_pipeline_create(VkDevice device,
          goto fail;
       }
 
+      p_atomic_add(&dev->cache_stats.compile_ns[MESA_SHADER_COMPUTE],
+                   os_time_get_nano() - compile_start);
+
       shader = tu_pipeline_cache_insert(cache, shader);
    }
 
@@ -4598,9 +5142,21 @@ tu_CreateComputePipelines(VkDevice device,
                           VkPipeline *pPipelines)
 {
    MESA_TRACE_FUNC();
+   VK_FROM_HANDLE(tu_device, dev, device);
    VkResult final_result = VK_SUCCESS;
    uint32_t i = 0;
 
+   struct tu_pipeline_batch batch = {
+      .device = device,
+      .cache = pipelineCache,
+      .compute_infos = pCreateInfos,
+      .alloc = pAllocator,
+      .pipelines = pPipelines,
+      .count = count,
+   };
+   if (tu_create_pipeline_batch<CHIP>(dev, &batch, &final_result))
+      return final_result;
+
    for (; i < count; i++) {
       VkPipelineCreateFlags2KHR flags =
          vk_compute_pipeline_create_flags(&pCreateInfos[i]);
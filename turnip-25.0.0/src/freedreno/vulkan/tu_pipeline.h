@@ -200,6 +200,33 @@ struct tu_graphics_lib_pipeline {
    bool independent_sets;
 };
 
+/* A link-time optimized replacement for the program of a pipeline that was
+ * fast-linked from libraries, compiled in the background once the pipeline
+ * has been bound often enough.
+ */
+struct tu_pipeline_lto {
+   struct tu_device *device;
+   struct tu_pipeline *pipeline;
+
+   VkPipelineCreateFlags2KHR flags;
+   VkGraphicsPipelineLibraryFlagsEXT state;
+   struct tu_pipeline_layout layout;
+
+   /* The retained NIR of the libraries, kept alive by nir_shaders. */
+   struct tu_nir_shaders *nir_shaders[MESA_SHADER_FRAGMENT + 1];
+   nir_shader *nir[MESA_SHADER_FRAGMENT + 1];
+   struct tu_shader_key keys[MESA_SHADER_FRAGMENT + 1];
+
+   uint32_t bind_count;
+   struct util_queue_fence fence;
+
+   /* Only valid once ready is set. */
+   bool ready;
+   struct tu_cs cs;
+   struct tu_shader *shaders[MESA_SHADER_STAGES];
+   struct tu_program_state program;
+};
+
 struct tu_graphics_pipeline {
    struct tu_pipeline base;
 
@@ -212,6 +239,8 @@ struct tu_graphics_pipeline {
 
    VkImageAspectFlags feedback_loops;
    bool feedback_loop_may_involve_textures;
+
+   struct tu_pipeline_lto *lto;
 };
 
 struct tu_compute_pipeline {
@@ -241,12 +270,19 @@ VkOffset2D tu_fdm_per_bin_offset(VkExtent2D frag_area, VkRect2D bin);
 template <chip CHIP>
 uint32_t tu_emit_draw_state(struct tu_cmd_buffer *cmd);
 
-struct tu_pvtmem_config {
-   uint64_t iova;
-   uint32_t per_fiber_size;
-   uint32_t per_sp_size;
-   bool per_wave;
-};
+void
+tu_pipeline_cache_stats_dump(struct tu_device *dev, bool force);
+
+template <chip CHIP>
+void
+tu_emit_shader_object_program_state(struct tu_cs *sub_cs,
+                                    struct tu_program_state *prog,
+                                    struct tu_shader **shaders,
+                                    uint32_t view_mask);
+
+const struct tu_pipeline_lto *
+tu_pipeline_lto_bind(struct tu_device *dev,
+                     struct tu_graphics_pipeline *pipeline);
 
 template <chip CHIP>
 void
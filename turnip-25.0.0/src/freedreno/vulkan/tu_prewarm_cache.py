@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+# Copyright © 2025 Google LLC
+# SPDX-License-Identifier: MIT
+
+"""Builds a pre-warmed Turnip pipeline cache from Fossilize databases.
+
+Every pipeline in the given Fossilize databases is replayed with
+fossilize-replay against Turnip running on top of the freedreno noop
+drm-shim, so that no GPU is needed. The resulting VkPipelineCache blob is
+only valid for the chosen GPU and for Turnip builds of the same Mesa version
+and git revision, on any CPU architecture. It is loaded read-only at device
+creation by pointing TU_PREWARM_CACHE at it.
+
+Example:
+
+   tu_prewarm_cache.py --gpu-id 660 \\
+      --drm-shim $prefix/lib/libfreedreno_noop_drm_shim.so \\
+      --icd $prefix/share/vulkan/icd.d/freedreno_icd.x86_64.json \\
+      -o game-a660.tucache game.foz
+"""
+
+import argparse
+import hashlib
+import os
+import re
+import struct
+import subprocess
+import sys
+
+# VkPipelineCacheHeaderVersionOne followed by the vk_pipeline_cache object
+# count.
+HEADER = struct.Struct('<IIII16sI')
+QUALCOMM_VENDOR_ID = 0x5143
+
+
+def drm_shim_env(gpu_id, drm_shim, icd=None):
+    """Environment running Turnip on the noop drm-shim for the given GPU."""
+    env = dict(os.environ)
+    env['FD_GPU_ID'] = str(gpu_id)
+    env['LD_PRELOAD'] = ':'.join(filter(None, [drm_shim,
+                                               env.get('LD_PRELOAD')]))
+    if icd:
+        env['VK_DRIVER_FILES'] = icd
+    # Compile everything for real instead of hitting the host's disk cache,
+    # and don't fill it with shaders for a GPU it doesn't have.
+    env['MESA_SHADER_CACHE_DISABLE'] = 'true'
+    # A pre-warmed cache would hide missing pipelines.
+    env.pop('TU_PREWARM_CACHE', None)
+    return env
+
+
+def replay_env(args):
+    env = drm_shim_env(args.gpu_id, args.drm_shim, args.icd)
+    # Debug flags could change the compiled shaders.
+    env.pop('TU_DEBUG', None)
+    return env
+
+
+def replay(args, database):
+    env = replay_env(args)
+
+    cmd = [args.fossilize_replay,
+           '--on-disk-pipeline-cache', args.output,
+           '--num-threads', str(args.jobs)]
+    cmd.append(database)
+
+    if args.verbose:
+        print(' '.join(cmd), file=sys.stderr)
+
+    return subprocess.run(cmd, env=env).returncode
+
+
+def driver_info(args):
+    """VkPhysicalDeviceDriverProperties::driverInfo of the replayed Turnip."""
+    out = subprocess.run([args.vulkaninfo, '--summary'], env=replay_env(args),
+                         stdout=subprocess.PIPE, text=True,
+                         check=True).stdout
+    match = re.search(r'^\s*driverInfo\s*=\s*(.*?)\s*$', out, re.MULTILINE)
+    if not match:
+        sys.exit(f'{args.vulkaninfo}: no driverInfo reported')
+    return match.group(1)
+
+
+def prewarm_uuid(info, chip_id):
+    """Matches tu_device_get_prewarm_uuid(), without any TU_DEBUG flags."""
+    sha1 = hashlib.sha1(info.encode() + struct.pack('<IQ', chip_id, 0))
+    return sha1.digest()[:16]
+
+
+def finish_output(args):
+    with open(args.output, 'rb') as f:
+        data = bytearray(f.read())
+
+    if len(data) < HEADER.size:
+        sys.exit(f'{args.output}: no pipeline cache was written')
+
+    size, version, vendor_id, device_id, uuid, count = \
+        HEADER.unpack_from(data)
+    if size != 32 or version != 1 or vendor_id != QUALCOMM_VENDOR_ID:
+        sys.exit(f'{args.output}: not a Turnip pipeline cache')
+
+    # Replace the build specific pipeline cache UUID, so that builds for
+    # other architectures accept the cache.
+    info = driver_info(args)
+    uuid = prewarm_uuid(info, device_id)
+    HEADER.pack_into(data, 0, size, version, vendor_id, device_id, uuid, count)
+
+    with open(args.output, 'wb') as f:
+        f.write(data)
+
+    print(f'{args.output}: {count} objects, {len(data)} bytes, '
+          f'chip id 0x{device_id:x}, {info}')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--gpu-id', type=int, required=True,
+                        help='GPU id exposed by the drm-shim, e.g. 660')
+    parser.add_argument('--drm-shim', required=True,
+                        help='path to libfreedreno_noop_drm_shim.so')
+    parser.add_argument('--icd',
+                        help='Turnip ICD json, if not the installed one')
+    parser.add_argument('--fossilize-replay', default='fossilize-replay',
+                        help='fossilize-replay binary')
+    parser.add_argument('--vulkaninfo', default='vulkaninfo',
+                        help='vulkaninfo binary')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                        help='number of compile threads')
+    parser.add_argument('-o', '--output', required=True,
+                        help='pipeline cache blob to write')
+    parser.add_argument('-v', '--verbose', action='store_true')
+    parser.add_argument('databases', nargs='+',
+                        help='Fossilize databases (.foz) to replay')
+    args = parser.parse_args()
+
+    # Each replay loads the blob written by the previous one and adds its own
+    # pipelines, so start from scratch.
+    if os.path.exists(args.output):
+        os.unlink(args.output)
+
+    for database in args.databases:
+        ret = replay(args, database)
+        if ret != 0:
+            sys.exit(f'fossilize-replay failed on {database} ({ret})')
+
+    finish_output(args)
+
+
+if __name__ == '__main__':
+    main()
@@ -971,6 +971,7 @@ emit_begin_stat_query(struct tu_cmd_buffer *cmdbuf,
    }
 
    if (is_pipeline_query_with_compute_stage(pool->vk.pipeline_statistics)) {
+      cmdbuf->state.compute_counters_running++;
       tu_emit_event_write<CHIP>(cmdbuf, cs, FD_START_COMPUTE_CTRS);
    }
 
@@ -1359,6 +1360,7 @@ emit_end_stat_query(struct tu_cmd_buffer *cmdbuf,
    }
 
    if (is_pipeline_query_with_compute_stage(pool->vk.pipeline_statistics)) {
+      cmdbuf->state.compute_counters_running--;
       tu_emit_event_write<CHIP>(cmdbuf, cs, FD_STOP_COMPUTE_CTRS);
    }
 
@@ -79,6 +79,11 @@ queue_submit(struct vk_queue *_queue, struct vk_queue_submit *vk_submit)
    if (TU_DEBUG(LOG_SKIP_GMEM_OPS))
       tu_dbg_log_gmem_load_store_skips(device);
 
+   if (TU_DEBUG(PERF)) {
+      tu_dbg_log_draw_state_cache(device);
+      tu_dbg_log_dynamic_tiling_cache(device);
+   }
+
    pthread_mutex_lock(&device->submit_mutex);
 
    struct tu_cmd_buffer **cmd_buffers =
@@ -100,9 +105,12 @@ queue_submit(struct vk_queue *_queue, struct vk_queue_submit *vk_submit)
 
    struct tu_u_trace_submission_data *u_trace_submission_data = NULL;
 
-   void *submit = tu_submit_create(device);
-   if (!submit)
-      goto fail_create_submit;
+   void *submit = queue->submit;
+   if (!submit) {
+      submit = queue->submit = tu_submit_create(device);
+      if (!submit)
+         goto fail_create_submit;
+   }
 
    if (has_trace_points) {
       tu_u_trace_submission_data_create(
@@ -221,7 +229,7 @@ queue_submit(struct vk_queue *_queue, struct vk_queue_submit *vk_submit)
    u_trace_context_process(&device->trace_context, false);
 
 out:
-   tu_submit_finish(device, submit);
+   tu_submit_reset(device, submit);
 
 fail_create_submit:
    if (cmd_buffers != (struct tu_cmd_buffer **) vk_submit->command_buffers)
@@ -258,6 +266,7 @@ tu_queue_init(struct tu_device *device,
 
    queue->device = device;
    queue->priority = priority;
+   queue->submit = NULL;
    queue->vk.driver_submit = queue_submit;
 
    int ret = tu_drm_submitqueue_new(device, priority, &queue->msm_queue_id);
@@ -274,6 +283,8 @@ void
 tu_queue_finish(struct tu_queue *queue)
 {
    vk_queue_finish(&queue->vk);
+   if (queue->submit)
+      tu_submit_finish(queue->device, queue->submit);
    tu_drm_submitqueue_close(queue->device, queue->msm_queue_id);
 }
 
@@ -22,6 +22,11 @@ struct tu_queue
    uint32_t priority;
 
    int fence;           /* timestamp/fence of the last queue submission */
+
+   /* Kernel submit object, reset and reused by every submission on this
+    * queue so that the command arrays don't need to be reallocated.
+    */
+   void *submit;
 };
 VK_DEFINE_HANDLE_CASTS(tu_queue, vk.base, VkQueue, VK_OBJECT_TYPE_QUEUE)
 
@@ -16,6 +16,7 @@
 #include "ir3/ir3_compiler.h"
 #include "ir3/ir3_nir.h"
 
+#include "tu_cmd_buffer.h"
 #include "tu_device.h"
 #include "tu_descriptor_set.h"
 #include "tu_lrz.h"
@@ -35,20 +36,14 @@ init_ir3_nir_options(struct ir3_shader_nir_options *options,
    };
 }
 
-nir_shader *
-tu_spirv_to_nir(struct tu_device *dev,
-                void *mem_ctx,
-                VkPipelineCreateFlags2KHR pipeline_flags,
-                const VkPipelineShaderStageCreateInfo *stage_info,
-                const struct tu_shader_key *key,
-                gl_shader_stage stage)
+static struct spirv_to_nir_options
+tu_spirv_options(gl_shader_stage stage, bool lower_view_index_to_device_index)
 {
    /* TODO these are made-up */
-   const struct spirv_to_nir_options spirv_options = {
+   return (struct spirv_to_nir_options) {
       /* ViewID is a sysval in geometry stages and an input in the FS */
       .view_index_is_input =
-         stage == MESA_SHADER_FRAGMENT &&
-         !key->lower_view_index_to_device_index,
+         stage == MESA_SHADER_FRAGMENT && !lower_view_index_to_device_index,
 
       /* Use 16-bit math for RelaxedPrecision ALU ops */
       .mediump_16bit_alu = true,
@@ -68,18 +63,15 @@ tu_spirv_to_nir(struct tu_device *dev,
       /* Accessed via stg/ldg (not used with Vulkan?) */
       .global_addr_format = nir_address_format_64bit_global,
    };
+}
 
-   const nir_shader_compiler_options *nir_options =
-      ir3_get_compiler_options(dev->compiler);
-
-   nir_shader *nir;
-   VkResult result =
-      vk_pipeline_shader_stage_to_nir(&dev->vk, pipeline_flags, stage_info,
-                                      &spirv_options, nir_options,
-                                      mem_ctx, &nir);
-   if (result != VK_SUCCESS)
-      return NULL;
-
+/* Lowering and optimization done right after translating from SPIR-V, for
+ * both pipelines and shader objects.
+ */
+static void
+tu_preprocess_nir(struct tu_device *dev, nir_shader *nir,
+                  const struct tu_shader_key *key)
+{
    /* ir3 uses num_ubos and num_ssbos to track the number of *bindful*
     * UBOs/SSBOs, but spirv_to_nir sets them to the total number of objects
     * which is useless for us, so reset them here.
@@ -136,6 +128,31 @@ tu_spirv_to_nir(struct tu_device *dev,
    ir3_optimize_loop(dev->compiler, &options, nir);
 
    NIR_PASS_V(nir, nir_opt_conditional_discard);
+}
+
+nir_shader *
+tu_spirv_to_nir(struct tu_device *dev,
+                void *mem_ctx,
+                VkPipelineCreateFlags2KHR pipeline_flags,
+                const VkPipelineShaderStageCreateInfo *stage_info,
+                const struct tu_shader_key *key,
+                gl_shader_stage stage)
+{
+   const struct spirv_to_nir_options spirv_options =
+      tu_spirv_options(stage, key->lower_view_index_to_device_index);
+
+   const nir_shader_compiler_options *nir_options =
+      ir3_get_compiler_options(dev->compiler);
+
+   nir_shader *nir;
+   VkResult result =
+      vk_pipeline_shader_stage_to_nir(&dev->vk, pipeline_flags, stage_info,
+                                      &spirv_options, nir_options,
+                                      mem_ctx, &nir);
+   if (result != VK_SUCCESS)
+      return NULL;
+
+   tu_preprocess_nir(dev, nir, key);
 
    return nir;
 }
@@ -2250,6 +2267,8 @@ tu_upload_shader(struct tu_device *dev,
    if (result != VK_SUCCESS)
       return result;
 
+   p_atomic_add(&dev->cache_stats.upload_bytes, size * 4);
+
    uint32_t pvtmem_size = v->pvtmem_size;
    bool per_wave = v->pvtmem_per_wave;
 
@@ -2288,6 +2307,11 @@ tu_upload_shader(struct tu_device *dev,
    uint64_t binning_iova = tu_upload_variant(&shader->cs, binning);
    uint64_t safe_const_iova = tu_upload_variant(&shader->cs, safe_const);
 
+   shader->pvtmem_config = pvtmem_config;
+   shader->iova = iova;
+   shader->binning_iova = binning_iova;
+   shader->safe_const_iova = safe_const_iova;
+
    struct tu_cs sub_cs;
    tu_cs_begin_sub_stream(&shader->cs, xs_size +
                           tu_xs_get_additional_cs_size_dwords(v), &sub_cs);
@@ -2330,6 +2354,45 @@ tu_upload_shader(struct tu_device *dev,
    return VK_SUCCESS;
 }
 
+template <chip CHIP>
+void
+tu_emit_vs_view_mask(struct tu_cs *sub_cs, const struct tu_shader *vs,
+                     bool safe_const, uint32_t view_mask,
+                     struct tu_draw_state *state,
+                     struct tu_draw_state *binning_state)
+{
+   const struct ir3_shader_variant *v =
+      safe_const ? vs->safe_const_variant : vs->variant;
+   const struct ir3_shader_variant *binning = vs->variant->binning;
+   struct tu_pvtmem_config pvtmem_config = vs->pvtmem_config;
+   struct tu_cs cs;
+
+   if (vs->variant->stream_output.num_outputs != 0)
+      binning = vs->variant;
+
+   const unsigned xs_size = 128;
+   const unsigned vpc_size =
+      32 + (vs->variant->stream_output.num_outputs != 0 ? 256 : 0);
+
+   tu_cs_begin_sub_stream(sub_cs, xs_size +
+                          tu_xs_get_additional_cs_size_dwords(v), &cs);
+   tu6_emit_variant<CHIP>(&cs, MESA_SHADER_VERTEX, v, &pvtmem_config,
+                          view_mask,
+                          safe_const ? vs->safe_const_iova : vs->iova);
+   *state = tu_cs_end_draw_state(sub_cs, &cs);
+
+   if (binning && binning_state) {
+      tu_cs_begin_sub_stream(sub_cs, xs_size + vpc_size +
+                             tu_xs_get_additional_cs_size_dwords(binning), &cs);
+      tu6_emit_variant<CHIP>(&cs, MESA_SHADER_VERTEX, binning,
+                             &pvtmem_config, view_mask, vs->binning_iova);
+      /* emit an empty VPC */
+      tu6_emit_vpc<CHIP>(&cs, binning, NULL, NULL, NULL, NULL);
+      *binning_state = tu_cs_end_draw_state(sub_cs, &cs);
+   }
+}
+TU_GENX(tu_emit_vs_view_mask);
+
 static bool
 tu_shader_serialize(struct vk_pipeline_cache_object *object,
                     struct blob *blob);
@@ -2419,14 +2482,12 @@ tu_shader_serialize(struct vk_pipeline_cache_object *object,
    return true;
 }
 
-static struct vk_pipeline_cache_object *
-tu_shader_deserialize(struct vk_pipeline_cache *cache,
-                      const void *key_data,
-                      size_t key_size,
-                      struct blob_reader *blob)
+static struct tu_shader *
+tu_shader_read(struct tu_device *dev,
+               const void *key_data,
+               size_t key_size,
+               struct blob_reader *blob)
 {
-   struct tu_device *dev =
-      container_of(cache->base.device, struct tu_device, vk);
    struct tu_shader *shader =
       tu_shader_init(dev, key_data, key_size);
 
@@ -2462,7 +2523,20 @@ tu_shader_deserialize(struct vk_pipeline_cache *cache,
       return NULL;
    }
 
-   return &shader->base;
+   return shader;
+}
+
+static struct vk_pipeline_cache_object *
+tu_shader_deserialize(struct vk_pipeline_cache *cache,
+                      const void *key_data,
+                      size_t key_size,
+                      struct blob_reader *blob)
+{
+   struct tu_device *dev =
+      container_of(cache->base.device, struct tu_device, vk);
+   struct tu_shader *shader = tu_shader_read(dev, key_data, key_size, blob);
+
+   return shader ? &shader->base : NULL;
 }
 
 VkResult
@@ -2788,6 +2862,82 @@ tu6_get_tessmode(const struct nir_shader *shader)
    }
 }
 
+struct tu_compile_shader_job {
+   struct tu_device *device;
+   struct tu_shader **shader;
+   nir_shader *nir;
+   void *mem_ctx;
+   const struct tu_shader_key *key;
+   const struct ir3_shader_key *ir3_key;
+   unsigned char sha1[21];
+   struct tu_pipeline_layout *layout;
+   bool executable_info;
+   VkPipelineCreationFeedback *feedback;
+   VkResult result;
+   struct util_queue_fence fence;
+};
+
+static void
+tu_compile_shader_job_run(struct tu_compile_shader_job *job)
+{
+   int64_t stage_start = os_time_get_nano();
+
+   gl_shader_stage stage = job->nir->info.stage;
+   job->result = tu_shader_create(job->device, job->shader, job->nir,
+                                  job->key, job->ir3_key, job->sha1,
+                                  sizeof(job->sha1), job->layout,
+                                  job->executable_info);
+
+   int64_t duration = os_time_get_nano() - stage_start;
+   job->feedback->duration += duration;
+   p_atomic_add(&job->device->cache_stats.compile_ns[stage], duration);
+}
+
+static void
+tu_compile_shader_job_execute(void *job, void *gdata, int thread_index)
+{
+   tu_compile_shader_job_run((struct tu_compile_shader_job *) job);
+}
+
+/* Run independent compile jobs in parallel, with the calling thread taking
+ * the last one, and free their mem_ctx.
+ */
+static VkResult
+tu_run_compile_shader_jobs(struct tu_device *device,
+                           struct tu_compile_shader_job *jobs,
+                           unsigned num_jobs)
+{
+   VkResult result = VK_SUCCESS;
+
+   bool threaded = num_jobs > 1 &&
+                   tu_device_can_use_worker_queue(device, NULL);
+   for (unsigned i = 0; i + 1 < num_jobs; i++) {
+      if (threaded) {
+         util_queue_fence_init(&jobs[i].fence);
+         util_queue_add_job(&device->worker_queue, &jobs[i],
+                            &jobs[i].fence, tu_compile_shader_job_execute,
+                            NULL, 0);
+      } else {
+         tu_compile_shader_job_run(&jobs[i]);
+      }
+   }
+
+   if (num_jobs > 0)
+      tu_compile_shader_job_run(&jobs[num_jobs - 1]);
+
+   for (unsigned i = 0; i < num_jobs; i++) {
+      if (threaded && i + 1 < num_jobs) {
+         util_queue_fence_wait(&jobs[i].fence);
+         util_queue_fence_destroy(&jobs[i].fence);
+      }
+      ralloc_free(jobs[i].mem_ctx);
+      if (jobs[i].result != VK_SUCCESS)
+         result = jobs[i].result;
+   }
+
+   return result;
+}
+
 VkResult
 tu_compile_shaders(struct tu_device *device,
                    VkPipelineCreateFlags2KHR pipeline_flags,
@@ -2821,8 +2971,10 @@ tu_compile_shaders(struct tu_device *device,
          goto fail;
       }
 
+      int64_t duration = os_time_get_nano() - stage_start;
       stage_feedbacks[stage].flags = VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT;
-      stage_feedbacks[stage].duration += os_time_get_nano() - stage_start;
+      stage_feedbacks[stage].duration += duration;
+      p_atomic_add(&device->cache_stats.compile_ns[stage], duration);
    }
 
    if (nir[MESA_SHADER_GEOMETRY])
@@ -2904,26 +3056,42 @@ tu_compile_shaders(struct tu_device *device,
    if (nir[MESA_SHADER_TESS_CTRL] && !nir[MESA_SHADER_FRAGMENT])
       ir3_key.tcs_store_primid = true;
 
-   for (gl_shader_stage stage = MESA_SHADER_VERTEX; stage < MESA_SHADER_STAGES;
-        stage = (gl_shader_stage) (stage + 1)) {
-      if (!nir[stage] || shaders[stage])
-         continue;
-
-      int64_t stage_start = os_time_get_nano();
+   /* After linking the stages are independent, so compile them in
+    * parallel.
+    */
+   {
+      struct tu_compile_shader_job jobs[MESA_SHADER_STAGES];
+      unsigned num_jobs = 0;
 
-      unsigned char shader_sha1[21];
-      memcpy(shader_sha1, pipeline_sha1, 20);
-      shader_sha1[20] = (unsigned char) stage;
+      for (gl_shader_stage stage = MESA_SHADER_VERTEX;
+           stage < MESA_SHADER_STAGES; stage = (gl_shader_stage) (stage + 1)) {
+         if (!nir[stage] || shaders[stage])
+            continue;
 
-      result = tu_shader_create(device,
-                                &shaders[stage], nir[stage], &keys[stage],
-                                &ir3_key, shader_sha1, sizeof(shader_sha1),
-                                layout, !!nir_initial_disasm);
-      if (result != VK_SUCCESS) {
-         goto fail;
+         struct tu_compile_shader_job *job = &jobs[num_jobs++];
+         *job = (struct tu_compile_shader_job) {
+            .device = device,
+            .shader = &shaders[stage],
+            .nir = nir[stage],
+            .key = &keys[stage],
+            .ir3_key = &ir3_key,
+            .layout = layout,
+            .executable_info = !!nir_initial_disasm,
+            .feedback = &stage_feedbacks[stage],
+         };
+         memcpy(job->sha1, pipeline_sha1, 20);
+         job->sha1[20] = (unsigned char) stage;
+
+         /* The ir3 shader takes ownership of the NIR and frees it, which
+          * must not touch the shared mem_ctx from several threads at once.
+          */
+         job->mem_ctx = ralloc_context(NULL);
+         ralloc_steal(job->mem_ctx, nir[stage]);
       }
 
-      stage_feedbacks[stage].duration += os_time_get_nano() - stage_start;
+      result = tu_run_compile_shader_jobs(device, jobs, num_jobs);
+      if (result != VK_SUCCESS)
+         goto fail;
    }
 
    ralloc_free(mem_ctx);
@@ -3135,3 +3303,434 @@ tu_shader_destroy(struct tu_device *dev,
 
    vk_free(&dev->vk.alloc, shader);
 }
+
+/* VK_EXT_shader_object */
+
+static const struct nir_shader_compiler_options *
+tu_get_nir_options(struct vk_physical_device *vk_pdev,
+                   gl_shader_stage stage,
+                   const struct vk_pipeline_robustness_state *rs)
+{
+   struct tu_physical_device *pdev =
+      container_of(vk_pdev, struct tu_physical_device, vk);
+
+   return &pdev->nir_options;
+}
+
+static struct spirv_to_nir_options
+tu_get_spirv_options(struct vk_physical_device *vk_pdev,
+                     gl_shader_stage stage,
+                     const struct vk_pipeline_robustness_state *rs)
+{
+   return tu_spirv_options(stage, false);
+}
+
+static void
+tu_shader_object_key(struct tu_device *dev,
+                     const struct vk_shader_compile_info *info,
+                     struct tu_shader_key *key)
+{
+   *key = {};
+
+   const nir_shader *nir = info->nir;
+   VkPipelineShaderStageRequiredSubgroupSizeCreateInfo subgroup_info = {
+      .sType =
+         VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_REQUIRED_SUBGROUP_SIZE_CREATE_INFO,
+      .requiredSubgroupSize = nir->info.subgroup_size,
+   };
+   tu_shader_key_subgroup_size(
+      key, nir->info.subgroup_size == SUBGROUP_SIZE_VARYING,
+      info->flags & VK_SHADER_CREATE_REQUIRE_FULL_SUBGROUPS_BIT_EXT,
+      nir->info.subgroup_size >= SUBGROUP_SIZE_REQUIRE_4 ? &subgroup_info
+                                                         : NULL,
+      dev);
+
+   tu_shader_key_robustness(key, info->robustness);
+
+   if (info->stage == MESA_SHADER_FRAGMENT) {
+      /* Shader objects can only be used with dynamic rendering, and the
+       * input attachment mapping is dynamic, so assume any attachment may be
+       * read as an input attachment.
+       */
+      key->dynamic_renderpass = true;
+      key->read_only_input_attachments = 0;
+      key->fragment_density_map =
+         info->flags & VK_SHADER_CREATE_FRAGMENT_DENSITY_MAP_ATTACHMENT_BIT_EXT;
+   }
+}
+
+static void
+tu_shader_object_layout(const struct vk_shader_compile_info *info,
+                        struct tu_pipeline_layout *layout)
+{
+   *layout = {};
+
+   layout->num_sets = info->set_layout_count;
+   for (uint32_t i = 0; i < info->set_layout_count; i++) {
+      if (info->set_layouts[i]) {
+         layout->set[i].layout =
+            container_of(info->set_layouts[i],
+                         struct tu_descriptor_set_layout, vk);
+      }
+   }
+
+   for (uint32_t i = 0; i < info->push_constant_range_count; i++) {
+      const VkPushConstantRange *range = &info->push_constant_ranges[i];
+      layout->push_constant_size =
+         MAX2(layout->push_constant_size, range->offset + range->size);
+   }
+   layout->push_constant_size = align(layout->push_constant_size, 16);
+
+   tu_pipeline_layout_init(layout);
+}
+
+/* Returns the mask of tu_shader_object_variant (or tessellation mode minus
+ * one for the TCS) to compile. Linked shaders only need the variant
+ * matching the other stages of the link, unlinked shaders need everything
+ * nextStage allows.
+ */
+static uint32_t
+tu_shader_object_variant_mask(const struct vk_shader_compile_info *info,
+                              VkShaderStageFlags linked_stages,
+                              unsigned tessellation)
+{
+   VkShaderStageFlags next = info->next_stage_mask;
+   uint32_t mask;
+
+   switch (info->stage) {
+   case MESA_SHADER_VERTEX:
+      if (linked_stages & VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT)
+         return BIT(TU_SHADER_OBJECT_VARIANT_TESS);
+      if (linked_stages & VK_SHADER_STAGE_GEOMETRY_BIT)
+         return BIT(TU_SHADER_OBJECT_VARIANT_GS);
+      if (linked_stages & VK_SHADER_STAGE_FRAGMENT_BIT)
+         return BIT(TU_SHADER_OBJECT_VARIANT_DEFAULT);
+
+      mask = 0;
+      if ((next & VK_SHADER_STAGE_FRAGMENT_BIT) ||
+          !(next & (VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT |
+                    VK_SHADER_STAGE_GEOMETRY_BIT)))
+         mask |= BIT(TU_SHADER_OBJECT_VARIANT_DEFAULT);
+      if (next & VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT)
+         mask |= BIT(TU_SHADER_OBJECT_VARIANT_TESS);
+      if (next & VK_SHADER_STAGE_GEOMETRY_BIT)
+         mask |= BIT(TU_SHADER_OBJECT_VARIANT_GS);
+      return mask;
+   case MESA_SHADER_TESS_CTRL:
+      if (tessellation != IR3_TESS_NONE)
+         return BIT(tessellation - 1);
+      return BITFIELD_MASK(TU_SHADER_OBJECT_VARIANT_COUNT);
+   case MESA_SHADER_TESS_EVAL:
+      if (linked_stages & VK_SHADER_STAGE_GEOMETRY_BIT)
+         return BIT(TU_SHADER_OBJECT_VARIANT_GS);
+      if (linked_stages & VK_SHADER_STAGE_FRAGMENT_BIT)
+         return BIT(TU_SHADER_OBJECT_VARIANT_DEFAULT);
+
+      mask = 0;
+      if ((next & VK_SHADER_STAGE_FRAGMENT_BIT) ||
+          !(next & VK_SHADER_STAGE_GEOMETRY_BIT))
+         mask |= BIT(TU_SHADER_OBJECT_VARIANT_DEFAULT);
+      if (next & VK_SHADER_STAGE_GEOMETRY_BIT)
+         mask |= BIT(TU_SHADER_OBJECT_VARIANT_GS);
+      return mask;
+   default:
+      return BIT(TU_SHADER_OBJECT_VARIANT_DEFAULT);
+   }
+}
+
+static void
+tu_shader_object_ir3_key(struct ir3_shader_key *key, gl_shader_stage stage,
+                         unsigned variant, unsigned tessellation)
+{
+   *key = {};
+
+   switch (stage) {
+   case MESA_SHADER_VERTEX:
+      /* Only whether there is tessellation matters for the VS. */
+      if (variant == TU_SHADER_OBJECT_VARIANT_TESS)
+         key->tessellation = IR3_TESS_TRIANGLES;
+      else
+         key->has_gs = variant == TU_SHADER_OBJECT_VARIANT_GS;
+      break;
+   case MESA_SHADER_TESS_CTRL:
+      key->tessellation = variant + 1;
+      break;
+   case MESA_SHADER_TESS_EVAL:
+      key->tessellation = tessellation;
+      key->has_gs = variant == TU_SHADER_OBJECT_VARIANT_GS;
+      break;
+   case MESA_SHADER_GEOMETRY:
+      key->has_gs = true;
+      break;
+   default:
+      break;
+   }
+
+   /* We don't know whether the FS will read PrimID, so we need to
+    * unconditionally store it.
+    */
+   if (key->tessellation != IR3_TESS_NONE)
+      key->tcs_store_primid = true;
+}
+
+static void
+tu_shader_object_destroy(struct vk_device *vk_dev,
+                         struct vk_shader *vk_shader,
+                         const VkAllocationCallbacks *pAllocator)
+{
+   struct tu_shader_object *obj =
+      container_of(vk_shader, struct tu_shader_object, vk);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(obj->variants); i++) {
+      if (obj->variants[i])
+         vk_pipeline_cache_object_unref(vk_dev, &obj->variants[i]->base);
+   }
+
+   vk_shader_free(vk_dev, pAllocator, &obj->vk);
+}
+
+static bool
+tu_shader_object_serialize(struct vk_device *vk_dev,
+                           const struct vk_shader *vk_shader,
+                           struct blob *blob)
+{
+   const struct tu_shader_object *obj =
+      container_of(vk_shader, struct tu_shader_object, vk);
+
+   uint32_t mask = 0;
+   for (unsigned i = 0; i < ARRAY_SIZE(obj->variants); i++) {
+      if (obj->variants[i])
+         mask |= BIT(i);
+   }
+
+   blob_write_uint32(blob, obj->tessellation);
+   blob_write_uint32(blob, mask);
+
+   u_foreach_bit (i, mask) {
+      if (!tu_shader_serialize(&obj->variants[i]->base, blob))
+         return false;
+   }
+
+   return !blob->out_of_memory;
+}
+
+static const struct vk_shader_ops tu_shader_object_ops = {
+   .destroy = tu_shader_object_destroy,
+   .serialize = tu_shader_object_serialize,
+};
+
+static VkResult
+tu_shader_object_deserialize(struct vk_device *vk_dev,
+                             struct blob_reader *blob,
+                             uint32_t binary_version,
+                             const VkAllocationCallbacks *pAllocator,
+                             struct vk_shader **shader_out)
+{
+   struct tu_device *dev = container_of(vk_dev, struct tu_device, vk);
+
+   /* The stage is recorded by the runtime in the binary header, but we
+    * don't get it here, so it is taken from the first variant.
+    */
+   unsigned tessellation = blob_read_uint32(blob);
+   uint32_t mask = blob_read_uint32(blob);
+   if (blob->overrun || !mask ||
+       mask & ~BITFIELD_MASK(TU_SHADER_OBJECT_VARIANT_COUNT))
+      return vk_error(dev, VK_ERROR_INCOMPATIBLE_SHADER_BINARY_EXT);
+
+   struct tu_shader *variants[TU_SHADER_OBJECT_VARIANT_COUNT] = {};
+   u_foreach_bit (i, mask) {
+      unsigned char key = i;
+      variants[i] = tu_shader_read(dev, &key, sizeof(key), blob);
+      if (!variants[i])
+         goto fail;
+   }
+
+   {
+      unsigned first = ffs(mask) - 1;
+      gl_shader_stage stage = variants[first]->variant->type;
+
+      struct tu_shader_object *obj = (struct tu_shader_object *)
+         vk_shader_zalloc(vk_dev, &tu_shader_object_ops, stage, pAllocator,
+                          sizeof(*obj));
+      if (!obj)
+         goto fail;
+
+      obj->tessellation = tessellation;
+      memcpy(obj->variants, variants, sizeof(variants));
+
+      *shader_out = &obj->vk;
+      return VK_SUCCESS;
+   }
+
+fail:
+   for (unsigned i = 0; i < ARRAY_SIZE(variants); i++) {
+      if (variants[i])
+         vk_pipeline_cache_object_unref(vk_dev, &variants[i]->base);
+   }
+
+   return vk_error(dev, VK_ERROR_INCOMPATIBLE_SHADER_BINARY_EXT);
+}
+
+static VkResult
+tu_compile_shader_objects(struct vk_device *vk_dev,
+                          uint32_t shader_count,
+                          struct vk_shader_compile_info *infos,
+                          const struct vk_graphics_pipeline_state *state,
+                          const VkAllocationCallbacks *pAllocator,
+                          struct vk_shader **shaders_out)
+{
+   struct tu_device *dev = container_of(vk_dev, struct tu_device, vk);
+   struct tu_shader_key keys[MESA_SHADER_STAGES];
+   struct tu_pipeline_layout layouts[MESA_SHADER_STAGES];
+   nir_shader *linked[MESA_SHADER_STAGES] = {};
+   VkShaderStageFlags linked_stages = 0;
+   VkResult result = VK_SUCCESS;
+
+   assert(shader_count <= MESA_SHADER_STAGES);
+
+   for (uint32_t i = 0; i < shader_count; i++) {
+      tu_shader_object_key(dev, &infos[i], &keys[i]);
+      tu_shader_object_layout(&infos[i], &layouts[i]);
+      tu_preprocess_nir(dev, infos[i].nir, &keys[i]);
+      shaders_out[i] = NULL;
+   }
+
+   if (shader_count > 1) {
+      for (uint32_t i = 0; i < shader_count; i++) {
+         linked[infos[i].stage] = infos[i].nir;
+         linked_stages |= mesa_to_vk_shader_stage(infos[i].stage);
+      }
+
+      tu_link_shaders(linked, MESA_SHADER_STAGES);
+
+      /* Like with pipelines, merge the tessellation modes onto the TES. */
+      nir_shader *tcs = linked[MESA_SHADER_TESS_CTRL];
+      nir_shader *tes = linked[MESA_SHADER_TESS_EVAL];
+      if (tcs && tes) {
+         if (tes->info.tess._primitive_mode == TESS_PRIMITIVE_UNSPECIFIED)
+            tes->info.tess._primitive_mode = tcs->info.tess._primitive_mode;
+         tes->info.tess.point_mode |= tcs->info.tess.point_mode;
+         tes->info.tess.ccw |= tcs->info.tess.ccw;
+         if (tes->info.tess.spacing == TESS_SPACING_UNSPECIFIED)
+            tes->info.tess.spacing = tcs->info.tess.spacing;
+         if (tcs->info.tess.tcs_vertices_out == 0)
+            tcs->info.tess.tcs_vertices_out = tes->info.tess.tcs_vertices_out;
+      }
+   }
+
+   /* Every variant of every shader is independent, so compile them all in
+    * parallel.
+    */
+   struct tu_compile_shader_job
+      jobs[MESA_SHADER_STAGES * TU_SHADER_OBJECT_VARIANT_COUNT];
+   struct ir3_shader_key ir3_keys[ARRAY_SIZE(jobs)];
+   VkPipelineCreationFeedback feedbacks[ARRAY_SIZE(jobs)] = {};
+   unsigned num_jobs = 0;
+
+   for (uint32_t i = 0; i < shader_count; i++) {
+      const struct vk_shader_compile_info *info = &infos[i];
+
+      struct tu_shader_object *obj = (struct tu_shader_object *)
+         vk_shader_zalloc(vk_dev, &tu_shader_object_ops, info->stage,
+                          pAllocator, sizeof(*obj));
+      if (!obj) {
+         result = vk_error(dev, VK_ERROR_OUT_OF_HOST_MEMORY);
+         break;
+      }
+      shaders_out[i] = &obj->vk;
+
+      unsigned tessellation = IR3_TESS_NONE;
+      if (info->stage == MESA_SHADER_TESS_CTRL) {
+         tessellation = tu6_get_tessmode(info->nir);
+         if (linked[MESA_SHADER_TESS_EVAL])
+            tessellation = tu6_get_tessmode(linked[MESA_SHADER_TESS_EVAL]);
+      } else if (info->stage == MESA_SHADER_TESS_EVAL) {
+         tessellation = tu6_get_tessmode(info->nir);
+         if (tessellation == IR3_TESS_NONE)
+            tessellation = IR3_TESS_TRIANGLES;
+         obj->tessellation = tessellation;
+      }
+
+      uint32_t mask =
+         tu_shader_object_variant_mask(info, linked_stages, tessellation);
+      u_foreach_bit (variant, mask) {
+         struct tu_compile_shader_job *job = &jobs[num_jobs];
+         struct ir3_shader_key *ir3_key = &ir3_keys[num_jobs];
+
+         tu_shader_object_ir3_key(ir3_key, info->stage, variant,
+                                  tessellation);
+
+         *job = (struct tu_compile_shader_job) {
+            .device = dev,
+            .shader = &obj->variants[variant],
+            .key = &keys[i],
+            .ir3_key = ir3_key,
+            .layout = &layouts[i],
+            .feedback = &feedbacks[num_jobs],
+         };
+         job->sha1[0] = (unsigned char) info->stage;
+         job->sha1[1] = (unsigned char) variant;
+
+         /* ir3 takes ownership of the NIR, so each variant gets a copy. */
+         job->mem_ctx = ralloc_context(NULL);
+         job->nir = nir_shader_clone(job->mem_ctx, info->nir);
+         num_jobs++;
+      }
+   }
+
+   for (uint32_t i = 0; i < shader_count; i++)
+      ralloc_free(infos[i].nir);
+
+   if (result == VK_SUCCESS) {
+      result = tu_run_compile_shader_jobs(dev, jobs, num_jobs);
+   } else {
+      for (unsigned i = 0; i < num_jobs; i++)
+         ralloc_free(jobs[i].mem_ctx);
+   }
+
+   if (result != VK_SUCCESS) {
+      for (uint32_t i = 0; i < shader_count; i++) {
+         if (shaders_out[i]) {
+            tu_shader_object_destroy(vk_dev, shaders_out[i], pAllocator);
+            shaders_out[i] = NULL;
+         }
+      }
+   }
+
+   return result;
+}
+
+struct tu_shader *
+tu_shader_object_variant(const struct tu_shader_object *obj,
+                         unsigned tessellation, bool has_gs)
+{
+   switch (obj->vk.stage) {
+   case MESA_SHADER_VERTEX:
+      if (tessellation != IR3_TESS_NONE)
+         return obj->variants[TU_SHADER_OBJECT_VARIANT_TESS];
+      return obj->variants[has_gs ? TU_SHADER_OBJECT_VARIANT_GS
+                                  : TU_SHADER_OBJECT_VARIANT_DEFAULT];
+   case MESA_SHADER_TESS_CTRL:
+      /* A TCS declaring its mode only has the variant for it. */
+      if (tessellation != IR3_TESS_NONE && obj->variants[tessellation - 1])
+         return obj->variants[tessellation - 1];
+      for (unsigned i = 0; i < ARRAY_SIZE(obj->variants); i++) {
+         if (obj->variants[i])
+            return obj->variants[i];
+      }
+      unreachable("shader object without variants");
+   case MESA_SHADER_TESS_EVAL:
+      return obj->variants[has_gs ? TU_SHADER_OBJECT_VARIANT_GS
+                                  : TU_SHADER_OBJECT_VARIANT_DEFAULT];
+   default:
+      return obj->variants[TU_SHADER_OBJECT_VARIANT_DEFAULT];
+   }
+}
+
+const struct vk_device_shader_ops tu_device_shader_ops = {
+   .get_nir_options = tu_get_nir_options,
+   .get_spirv_options = tu_get_spirv_options,
+   .compile = tu_compile_shader_objects,
+   .deserialize = tu_shader_object_deserialize,
+   .cmd_bind_shaders = tu_cmd_bind_shaders,
+};
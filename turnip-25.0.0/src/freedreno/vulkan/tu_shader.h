@@ -14,6 +14,7 @@
 #include "tu_cs.h"
 #include "tu_suballoc.h"
 #include "tu_descriptor_set.h"
+#include "vk_shader.h"
 
 struct tu_inline_ubo
 {
@@ -55,6 +56,13 @@ struct tu_const_state
    struct ir3_driver_ubo inline_uniforms_ubo;
 };
 
+struct tu_pvtmem_config {
+   uint64_t iova;
+   uint32_t per_fiber_size;
+   uint32_t per_sp_size;
+   bool per_wave;
+};
+
 struct tu_shader
 {
    struct vk_pipeline_cache_object base;
@@ -70,6 +78,12 @@ struct tu_shader
    struct tu_draw_state safe_const_state;
    struct tu_draw_state binning_state;
 
+   /* Kept so that the VS draw states can be re-emitted with the view mask of
+    * the render pass when linking shader objects at draw time.
+    */
+   struct tu_pvtmem_config pvtmem_config;
+   uint64_t iova, binning_iova, safe_const_iova;
+
    struct tu_const_state const_state;
    uint32_t view_mask;
    uint8_t active_desc_sets;
@@ -115,7 +129,37 @@ struct tu_shader_key {
    enum ir3_wavesize_option api_wavesize, real_wavesize;
 };
 
+/* Unlinked shader objects don't know which stages they will be used with,
+ * but the ir3 key of a stage depends on whether there is tessellation and
+ * geometry shading after it. Each shader object is precompiled for all the
+ * combinations allowed by nextStage, and the variant matching the bound
+ * stages is picked when linking at draw time:
+ *
+ * - VS: default, as ES (followed by a GS) or as LS (followed by a TCS)
+ * - TCS: one variant per tessellation mode, unless the TCS declares it
+ * - TES: default or as ES
+ */
+enum tu_shader_object_variant {
+   TU_SHADER_OBJECT_VARIANT_DEFAULT,
+   TU_SHADER_OBJECT_VARIANT_GS,
+   TU_SHADER_OBJECT_VARIANT_TESS,
+   TU_SHADER_OBJECT_VARIANT_COUNT,
+};
+
+struct tu_shader_object
+{
+   struct vk_shader vk;
+
+   /* For the TES, the tessellation mode it declares. */
+   unsigned tessellation;
+
+   /* For the TCS these are indexed by the tessellation mode minus one. */
+   struct tu_shader *variants[TU_SHADER_OBJECT_VARIANT_COUNT];
+};
+
 extern const struct vk_pipeline_cache_object_ops tu_shader_ops;
+extern const struct vk_device_shader_ops tu_device_shader_ops;
+
 bool
 tu_nir_lower_multiview(nir_shader *nir, uint32_t mask, struct tu_device *dev);
 
@@ -194,6 +238,17 @@ tu_compile_shaders(struct tu_device *device,
                    nir_shader **nir_out,
                    VkPipelineCreationFeedback *stage_feedbacks);
 
+struct tu_shader *
+tu_shader_object_variant(const struct tu_shader_object *obj,
+                         unsigned tessellation, bool has_gs);
+
+template <chip CHIP>
+void
+tu_emit_vs_view_mask(struct tu_cs *sub_cs, const struct tu_shader *vs,
+                     bool safe_const, uint32_t view_mask,
+                     struct tu_draw_state *state,
+                     struct tu_draw_state *binning_state);
+
 VkResult
 tu_init_empty_shaders(struct tu_device *device);
 
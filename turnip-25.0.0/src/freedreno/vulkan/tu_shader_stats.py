@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+# Copyright © 2025 Google LLC
+# SPDX-License-Identifier: MIT
+
+"""Collects and compares Turnip shader statistics without a GPU.
+
+The "run" command replays Fossilize databases with fossilize-replay against
+Turnip on top of the freedreno noop drm-shim. Pipelines go through the same
+tu_spirv_to_nir/tu_compile_shaders path as on a device, with the shader keys
+derived from the captured pipeline state. Pipelines are compiled in parallel
+on all CPU cores, and the VK_KHR_pipeline_executable_properties statistics of
+every shader are written to a CSV file.
+
+The "report" command sums up the statistics in one CSV file, or compares two
+of them and lists how many shaders each statistic helped or hurt.
+
+Example:
+
+   tu_shader_stats.py run --gpu-id 740 \\
+      --drm-shim $prefix/lib/libfreedreno_noop_drm_shim.so \\
+      -o before.csv fossils/*.foz
+   # rebuild with the compiler change
+   tu_shader_stats.py run ... -o after.csv fossils/*.foz
+   tu_shader_stats.py report before.csv after.csv
+"""
+
+import argparse
+import csv
+import os
+import subprocess
+import sys
+import tempfile
+
+from tu_prewarm_cache import drm_shim_env
+
+# Columns identifying a shader, as written by fossilize-replay.
+KEY_COLUMNS = ('Database', 'Pipeline hash', 'Executable name')
+
+# Statistics where a smaller value is not an improvement.
+HIGHER_IS_BETTER = ('Max Waves Per Core',)
+
+
+def run(args):
+    env = drm_shim_env(args.gpu_id, args.drm_shim, args.icd)
+
+    with open(args.output, 'w', newline='') as out, \
+         tempfile.TemporaryDirectory() as tmpdir:
+        writer = None
+        for database in args.databases:
+            stats_path = os.path.join(tmpdir, 'stats.csv')
+            cmd = [args.fossilize_replay,
+                   '--enable-pipeline-stats', stats_path,
+                   '--num-threads', str(args.jobs),
+                   database]
+            if args.verbose:
+                print(' '.join(cmd), file=sys.stderr)
+
+            ret = subprocess.run(cmd, env=env).returncode
+            if ret != 0:
+                sys.exit(f'fossilize-replay failed on {database} ({ret})')
+
+            with open(stats_path, newline='') as f:
+                reader = csv.DictReader(f)
+                if writer is None:
+                    fieldnames = list(reader.fieldnames)
+                    if 'Database' not in fieldnames:
+                        fieldnames.insert(0, 'Database')
+                    writer = csv.DictWriter(out, fieldnames)
+                    writer.writeheader()
+                for row in reader:
+                    row['Database'] = os.path.basename(database)
+                    writer.writerow(row)
+
+
+def load(path):
+    shaders = {}
+    with open(path, newline='') as f:
+        for row in csv.DictReader(f):
+            key = tuple(row.pop(column, '') for column in KEY_COLUMNS)
+            stats = {}
+            for name, value in row.items():
+                try:
+                    stats[name] = int(value)
+                except (TypeError, ValueError):
+                    pass
+            shaders[key] = stats
+    return shaders
+
+
+def totals(shaders):
+    result = {}
+    for stats in shaders.values():
+        for name, value in stats.items():
+            result[name] = result.get(name, 0) + value
+    return result
+
+
+def report_one(shaders):
+    print(f'{len(shaders)} shaders')
+    for name, total in totals(shaders).items():
+        print(f'{name:40} {total:14}')
+
+
+def report_diff(before, after):
+    common = before.keys() & after.keys()
+    if len(common) != len(before) or len(common) != len(after):
+        print(f'{len(before) - len(common)} shaders only in the first file, '
+              f'{len(after) - len(common)} only in the second file',
+              file=sys.stderr)
+
+    old = totals({key: before[key] for key in common})
+    new = totals({key: after[key] for key in common})
+
+    print(f'{len(common)} shaders in common')
+    print(f'{"":40} {"before":>14} {"after":>14} {"change":>9} '
+          f'{"helped":>7} {"hurt":>7}')
+    for name in old:
+        if name not in new:
+            continue
+
+        sign = -1 if name in HIGHER_IS_BETTER else 1
+        helped = hurt = 0
+        for key in common:
+            delta = (after[key].get(name, 0) - before[key].get(name, 0)) * sign
+            if delta < 0:
+                helped += 1
+            elif delta > 0:
+                hurt += 1
+
+        change = (f'{100.0 * (new[name] - old[name]) / old[name]:+8.2f}%'
+                  if old[name] else '')
+        print(f'{name:40} {old[name]:14} {new[name]:14} {change:>9} '
+              f'{helped:7} {hurt:7}')
+
+
+def report(args):
+    if len(args.csv) == 1:
+        report_one(load(args.csv[0]))
+    elif len(args.csv) == 2:
+        report_diff(load(args.csv[0]), load(args.csv[1]))
+    else:
+        sys.exit('report takes one or two CSV files')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    parser_run = subparsers.add_parser('run', help='collect statistics')
+    parser_run.add_argument('--gpu-id', type=int, required=True,
+                            help='GPU id exposed by the drm-shim, e.g. 740')
+    parser_run.add_argument('--drm-shim', required=True,
+                            help='path to libfreedreno_noop_drm_shim.so')
+    parser_run.add_argument('--icd',
+                            help='Turnip ICD json, if not the installed one')
+    parser_run.add_argument('--fossilize-replay', default='fossilize-replay',
+                            help='fossilize-replay binary')
+    parser_run.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                            help='number of compile threads')
+    parser_run.add_argument('-o', '--output', required=True,
+                            help='CSV file to write')
+    parser_run.add_argument('-v', '--verbose', action='store_true')
+    parser_run.add_argument('databases', nargs='+',
+                            help='Fossilize databases (.foz) to replay')
+    parser_run.set_defaults(func=run)
+
+    parser_report = subparsers.add_parser('report',
+                                          help='summarize or compare')
+    parser_report.add_argument('csv', nargs='+',
+                               help='statistics from "run", before and after')
+    parser_report.set_defaults(func=report)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == '__main__':
+    main()
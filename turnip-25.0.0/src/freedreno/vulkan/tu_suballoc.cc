@@ -82,9 +82,10 @@ tu_suballoc_bo_alloc(struct tu_suballoc_bo *suballoc_bo,
 
    /* Allocate the new BO if we didn't have one cached. */
    if (!suballoc->bo) {
-      VkResult result = tu_bo_init_new(suballoc->dev, NULL,
-                                       &suballoc->bo, alloc_size,
-                                       suballoc->flags, suballoc->name);
+      VkResult result = tu_bo_init_new(
+         suballoc->dev, NULL, &suballoc->bo, alloc_size,
+         (enum tu_bo_alloc_flags) (suballoc->flags | TU_BO_ALLOC_RECYCLABLE),
+         suballoc->name);
       if (result != VK_SUCCESS)
          return result;
    }
@@ -47,6 +47,8 @@ static const struct debug_control tu_debug_options[] = {
    { "noconcurrentresolves", TU_DEBUG_NO_CONCURRENT_RESOLVES },
    { "noconcurrentunresolves", TU_DEBUG_NO_CONCURRENT_UNRESOLVES },
    { "dumpas", TU_DEBUG_DUMPAS },
+   { "cachestats", TU_DEBUG_CACHESTATS },
+   { "blitbuffers", TU_DEBUG_BLIT_BUFFERS },
    { NULL, 0 }
 };
 
@@ -62,7 +64,8 @@ const uint32_t tu_runtime_debug_flags =
    TU_DEBUG_PERF | TU_DEBUG_FLUSHALL | TU_DEBUG_SYNCDRAW |
    TU_DEBUG_RAST_ORDER | TU_DEBUG_UNALIGNED_STORE |
    TU_DEBUG_LOG_SKIP_GMEM_OPS | TU_DEBUG_3D_LOAD | TU_DEBUG_FDM |
-   TU_DEBUG_NO_CONCURRENT_RESOLVES | TU_DEBUG_NO_CONCURRENT_UNRESOLVES;
+   TU_DEBUG_NO_CONCURRENT_RESOLVES | TU_DEBUG_NO_CONCURRENT_UNRESOLVES |
+   TU_DEBUG_BLIT_BUFFERS;
 
 os_file_notifier_t tu_debug_notifier;
 struct tu_env tu_env;
@@ -84,7 +87,7 @@ tu_env_notify(
       }
    }
 
-   int runtime_flags = file_flags & tu_runtime_debug_flags;
+   uint32_t runtime_flags = file_flags & tu_runtime_debug_flags;
    if (unlikely(runtime_flags != file_flags)) {
       mesa_logw(
          "Certain options in TU_DEBUG_FILE don't support runtime changes: 0x%x, ignoring",
@@ -192,6 +195,58 @@ __vk_startup_errorf(struct tu_instance *instance,
    return error;
 }
 
+static void
+tu_tiling_config_update_pipe_layout(struct tu_tiling_config *tiling,
+                                    const struct tu_device *dev);
+
+static bool
+is_hw_binning_possible(const struct tu_tiling_config *tiling);
+
+/* Rough costs of a tile layout, in bytes of memory traffic. Every bin
+ * replays the draw stream and flushes the caches, every VSC pipe has its own
+ * visibility stream written by the binning pass and read back by each of
+ * its bins, and geometry straddling the seam between two bins is fetched and
+ * rasterized once for each of them.
+ */
+#define TU_BIN_COST_BYTES            (64 * 1024)
+#define TU_VSC_PIPE_COST_BYTES       (4 * 1024)
+#define TU_SEAM_COST_BYTES_PER_PIXEL 16
+
+/* Estimates the memory traffic of rendering to the whole framebuffer with
+ * the given tile layout. The GMEM loads and stores only touch the part of
+ * each bin inside the framebuffer, so they are the same for all layouts and
+ * only make the estimate comparable to the sysmem bandwidth.
+ */
+uint64_t
+tu_tile_layout_cost(const struct tu_framebuffer *fb,
+                    const struct tu_device *dev,
+                    const struct tu_render_pass *pass,
+                    VkExtent2D tile_count,
+                    uint32_t layers)
+{
+   struct tu_tiling_config tiling = {
+      .tile_count = tile_count,
+   };
+   tu_tiling_config_update_pipe_layout(&tiling, dev);
+
+   const uint64_t bins = tile_count.width * tile_count.height;
+   const uint64_t pipes = tiling.pipe_count.width * tiling.pipe_count.height;
+   const uint64_t seam_pixels =
+      (uint64_t) (tile_count.width - 1) * fb->height +
+      (uint64_t) (tile_count.height - 1) * fb->width;
+
+   uint64_t cost =
+      (uint64_t) pass->gmem_bandwidth_per_pixel * fb->width * fb->height +
+      bins * TU_BIN_COST_BYTES + pipes * TU_VSC_PIPE_COST_BYTES +
+      seam_pixels * TU_SEAM_COST_BYTES_PER_PIXEL;
+
+   /* Without HW binning every bin processes all of the geometry. */
+   if (!is_hw_binning_possible(&tiling))
+      cost += bins * TU_BIN_COST_BYTES;
+
+   return cost * layers;
+}
+
 static void
 tu_tiling_config_update_tile_layout(struct tu_framebuffer *fb,
                                     const struct tu_device *dev,
@@ -249,11 +304,11 @@ tu_tiling_config_update_tile_layout(struct tu_framebuffer *fb,
    if (!pass->gmem_pixels[gmem_layout])
       return;
 
-   uint32_t best_tile_count = ~0;
+   uint64_t best_cost = UINT64_MAX;
    VkExtent2D tile_count;
    VkExtent2D tile_size;
    /* There aren't that many different tile widths possible, so just walk all
-    * of them finding which produces the lowest number of bins.
+    * of them finding which has the lowest estimated cost.
     */
    const uint32_t max_tile_width = MIN2(
       dev->physical_device->info->tile_max_w, util_align_npot(fb->width, tile_align_w));
@@ -277,18 +332,18 @@ tu_tiling_config_update_tile_layout(struct tu_framebuffer *fb,
       tile_size.height =
          align(DIV_ROUND_UP(fb->height, tile_count.height), tile_align_h);
 
-      /* Pick the layout with the minimum number of bins (lowest CP overhead
-       * and amount of cache flushing), but the most square tiles in the case
-       * of a tie (likely highest cache locality).
+      /* Pick the layout with the lowest estimated cost, but the most square
+       * tiles in the case of a tie (likely highest cache locality).
        */
-      if (tile_count.width * tile_count.height < best_tile_count ||
-          (tile_count.width * tile_count.height == best_tile_count &&
+      uint64_t cost = tu_tile_layout_cost(fb, dev, pass, tile_count, layers);
+      if (cost < best_cost ||
+          (cost == best_cost &&
            abs((int)(tile_size.width - tile_size.height)) <
               abs((int)(tiling->tile0.width - tiling->tile0.height)))) {
          tiling->possible = true;
          tiling->tile0 = tile_size;
          tiling->tile_count = tile_count;
-         best_tile_count = tile_count.width * tile_count.height;
+         best_cost = cost;
       }
    }
 
@@ -425,6 +480,8 @@ tu_dbg_log_gmem_load_store_skips(struct tu_device *device)
    static uint32_t last_skipped_stores = 0;
    static uint32_t last_total_loads = 0;
    static uint32_t last_total_stores = 0;
+   static uint32_t last_total_bins = 0;
+   static uint32_t last_taken_bins = 0;
    static struct timespec last_time = {};
 
    pthread_mutex_lock(&device->submit_mutex);
@@ -445,6 +502,8 @@ tu_dbg_log_gmem_load_store_skips(struct tu_device *device)
    uint32_t current_taken_stores = global->dbg_gmem_taken_stores;
    uint32_t current_total_loads = global->dbg_gmem_total_loads;
    uint32_t current_total_stores = global->dbg_gmem_total_stores;
+   uint32_t current_total_bins = global->dbg_gmem_total_bins;
+   uint32_t current_taken_bins = global->dbg_gmem_taken_bins;
 
    uint32_t skipped_loads = current_total_loads - current_taken_loads;
    uint32_t skipped_stores = current_total_stores - current_taken_stores;
@@ -462,10 +521,54 @@ tu_dbg_log_gmem_load_store_skips(struct tu_device *device)
          current_time_frame_total_stores,
          current_time_frame_skipped_stores / (float) current_time_frame_total_stores * 100.f);
 
+   uint32_t current_time_frame_total_bins = current_total_bins - last_total_bins;
+   uint32_t current_time_frame_empty_bins =
+      current_time_frame_total_bins - (current_taken_bins - last_taken_bins);
+   mesa_logi("[GMEM] bins total: %u empty: %.1f%%\n",
+         current_time_frame_total_bins,
+         current_time_frame_empty_bins / (float) current_time_frame_total_bins * 100.f);
+
    last_skipped_loads = skipped_loads;
    last_skipped_stores = skipped_stores;
    last_total_loads = current_total_loads;
    last_total_stores = current_total_stores;
+   last_total_bins = current_total_bins;
+   last_taken_bins = current_taken_bins;
+
+   pthread_mutex_unlock(&device->submit_mutex);
+}
+
+void
+tu_dbg_log_draw_state_cache(struct tu_device *device)
+{
+   static uint64_t last_hits = 0;
+   static uint64_t last_bytes_saved = 0;
+   static struct timespec last_time = {};
+
+   pthread_mutex_lock(&device->submit_mutex);
+
+   struct timespec current_time;
+   clock_gettime(CLOCK_MONOTONIC, &current_time);
+
+   if (timespec_sub_to_nsec(&current_time, &last_time) > 1000 * 1000 * 1000) {
+      last_time = current_time;
+   } else {
+      pthread_mutex_unlock(&device->submit_mutex);
+      return;
+   }
+
+   uint64_t hits = p_atomic_read(&device->dbg_draw_state_cache_hits);
+   uint64_t bytes_saved =
+      p_atomic_read(&device->dbg_draw_state_cache_bytes_saved);
+
+   if (hits != last_hits) {
+      perf_debug(device, "draw state cache: %" PRIu64 " hits, %" PRIu64
+                 " bytes saved", hits - last_hits,
+                 bytes_saved - last_bytes_saved);
+   }
+
+   last_hits = hits;
+   last_bytes_saved = bytes_saved;
 
    pthread_mutex_unlock(&device->submit_mutex);
 }
@@ -67,6 +67,8 @@ enum tu_debug_flags
    TU_DEBUG_NO_CONCURRENT_RESOLVES = 1 << 27,
    TU_DEBUG_NO_CONCURRENT_UNRESOLVES = 1 << 28,
    TU_DEBUG_DUMPAS = 1 << 29,
+   TU_DEBUG_CACHESTATS = 1 << 30,
+   TU_DEBUG_BLIT_BUFFERS = 1u << 31,
 };
 
 struct tu_env {
@@ -128,6 +130,13 @@ tu_framebuffer_tiling_config(struct tu_framebuffer *fb,
                              const struct tu_device *device,
                              const struct tu_render_pass *pass);
 
+uint64_t
+tu_tile_layout_cost(const struct tu_framebuffer *fb,
+                    const struct tu_device *dev,
+                    const struct tu_render_pass *pass,
+                    VkExtent2D tile_count,
+                    uint32_t layers);
+
 #define TU_STAGE_MASK ((1 << MESA_SHADER_STAGES) - 1)
 
 #define tu_foreach_stage(stage, stage_bits)                                  \
@@ -454,6 +463,9 @@ tu6_pack_border_color(struct bcolor_entry *bcolor, const VkClearColorValue *val,
 void
 tu_dbg_log_gmem_load_store_skips(struct tu_device *device);
 
+void
+tu_dbg_log_draw_state_cache(struct tu_device *device);
+
 #define perf_debug(device, fmt, ...) do {                               \
    if (TU_DEBUG(PERF))                                                  \
       mesa_log(MESA_LOG_WARN, (MESA_LOG_TAG), (fmt), ##__VA_ARGS__);    \
@@ -16,6 +16,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "crc32.h"
@@ -93,6 +95,9 @@ static inline bool mesa_db_truncate(FILE *file, long pos)
 static bool
 mesa_db_reopen_file(struct mesa_cache_db_file *db_file);
 
+static void
+mesa_db_unmap_file(struct mesa_cache_db_file *db_file);
+
 static void
 mesa_db_close_file(struct mesa_cache_db_file *db_file);
 
@@ -227,6 +232,8 @@ mesa_db_write_header(struct mesa_cache_db_file *db_file,
       return false;
 
    if (reset) {
+      mesa_db_unmap_file(db_file);
+
       if (!mesa_db_truncate(db_file->file, ftell(db_file->file)))
          return false;
    }
@@ -251,6 +258,8 @@ mesa_db_zap(struct mesa_cache_db *db)
    /* Disable cache to prevent the recurring faults */
    db->alive = false;
 
+   mesa_db_unmap_file(&db->cache);
+
    /* Zap corrupted database files to start over from a clean slate */
    if (!mesa_db_truncate(db->cache.file, 0) ||
        !mesa_db_truncate(db->index.file, 0))
@@ -362,6 +371,9 @@ mesa_db_load(struct mesa_cache_db *db, bool reload)
          return false;
    }
 
+   /* The cache file may have been truncated by a compaction */
+   mesa_db_unmap_file(&db->cache);
+
    /* If file headers are invalid, then zap database files and start over */
    if (!mesa_db_load_header(&db->cache) ||
        !mesa_db_load_header(&db->index) ||
@@ -459,6 +471,49 @@ mesa_db_reopen_file(struct mesa_cache_db_file *db_file)
    return true;
 }
 
+static void
+mesa_db_unmap_file(struct mesa_cache_db_file *db_file)
+{
+   if (db_file->map) {
+      munmap(db_file->map, db_file->map_size);
+      db_file->map = NULL;
+      db_file->map_size = 0;
+   }
+}
+
+/* Returns a read-only mapping covering at least the first "size" bytes of
+ * the file, or NULL if the file can't be mapped. The cache file is only
+ * appended to between compactions, and any truncation changes the database
+ * UUID, which makes readers reload and drop the mapping. Hence the mapping
+ * is kept across locking and unlocking, and is only replaced when the file
+ * has grown past it.
+ */
+static const uint8_t *
+mesa_db_map_file(struct mesa_cache_db_file *db_file, uint64_t size)
+{
+   struct stat st;
+   void *map;
+
+   if (db_file->map && size <= db_file->map_size)
+      return db_file->map;
+
+   mesa_db_unmap_file(db_file);
+
+   /* Entries not flushed to the file yet can't be read through the mapping */
+   if (fstat(fileno(db_file->file), &st) || (uint64_t)st.st_size < size)
+      return NULL;
+
+   map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED,
+              fileno(db_file->file), 0);
+   if (map == MAP_FAILED)
+      return NULL;
+
+   db_file->map = map;
+   db_file->map_size = st.st_size;
+
+   return map;
+}
+
 static void
 mesa_db_close_file(struct mesa_cache_db_file *db_file)
 {
@@ -471,6 +526,8 @@ mesa_db_close_file(struct mesa_cache_db_file *db_file)
 static void
 mesa_db_free_file(struct mesa_cache_db_file *db_file)
 {
+   mesa_db_unmap_file(db_file);
+
    if (db_file->file)
       fclose(db_file->file);
 
@@ -654,6 +711,8 @@ mesa_db_compact(struct mesa_cache_db *db, int64_t blob_size,
    fflush(compacted_index);
 
    /* Cut off the the freed space left after compaction */
+   mesa_db_unmap_file(&db->cache);
+
    if (!mesa_db_truncate(db->cache.file, ftell(compacted_cache)) ||
        !mesa_db_truncate(db->index.file, ftell(compacted_index)))
       goto cleanup;
@@ -769,6 +828,7 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
    struct mesa_cache_db_file_entry cache_entry;
    struct mesa_index_db_file_entry index_entry;
    struct mesa_index_db_hash_entry *hash_entry;
+   const uint8_t *map;
    void *data = NULL;
 
    if (!mesa_db_lock(db))
@@ -787,21 +847,48 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
    if (!hash_entry)
       goto fail;
 
-   if (!mesa_db_seek(db->cache.file, hash_entry->cache_db_file_offset) ||
-       !mesa_db_read(db->cache.file, &cache_entry) ||
-       !mesa_db_cache_entry_valid(&cache_entry))
-      goto fail_fatal;
+   /* Read the entry straight from the page cache when the cache file can be
+    * mapped, which avoids seeking and reading through stdio on every lookup.
+    */
+   map = mesa_db_map_file(&db->cache, hash_entry->cache_db_file_offset +
+                                      blob_file_size(hash_entry->size));
+   if (map) {
+      const uint8_t *entry = map + hash_entry->cache_db_file_offset;
+
+      memcpy(&cache_entry, entry, sizeof(cache_entry));
+      if (!mesa_db_cache_entry_valid(&cache_entry) ||
+          cache_entry.size != hash_entry->size)
+         goto fail_fatal;
 
-   if (memcmp(cache_entry.key, cache_key_160bit, sizeof(cache_entry.key)))
-      goto fail;
+      if (memcmp(cache_entry.key, cache_key_160bit, sizeof(cache_entry.key)))
+         goto fail;
 
-   data = malloc(cache_entry.size);
-   if (!data)
-      goto fail;
+      if (util_hash_crc32(entry + sizeof(cache_entry),
+                          cache_entry.size) != cache_entry.crc)
+         goto fail_fatal;
 
-   if (!mesa_db_read_data(db->cache.file, data, cache_entry.size) ||
-       util_hash_crc32(data, cache_entry.size) != cache_entry.crc)
-      goto fail_fatal;
+      data = malloc(cache_entry.size);
+      if (!data)
+         goto fail;
+
+      memcpy(data, entry + sizeof(cache_entry), cache_entry.size);
+   } else {
+      if (!mesa_db_seek(db->cache.file, hash_entry->cache_db_file_offset) ||
+          !mesa_db_read(db->cache.file, &cache_entry) ||
+          !mesa_db_cache_entry_valid(&cache_entry))
+         goto fail_fatal;
+
+      if (memcmp(cache_entry.key, cache_key_160bit, sizeof(cache_entry.key)))
+         goto fail;
+
+      data = malloc(cache_entry.size);
+      if (!data)
+         goto fail;
+
+      if (!mesa_db_read_data(db->cache.file, data, cache_entry.size) ||
+          util_hash_crc32(data, cache_entry.size) != cache_entry.crc)
+         goto fail_fatal;
+   }
 
    if (!mesa_db_seek(db->index.file, hash_entry->index_db_file_offset) ||
        !mesa_db_read(db->index.file, &index_entry) ||
@@ -26,6 +26,8 @@ struct mesa_cache_db_file {
    char *path;
    off_t offset;
    uint64_t uuid;
+   void *map;
+   size_t map_size;
 };
 
 struct mesa_cache_db {